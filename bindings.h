@@ -3,3 +3,6 @@
 #include "components/ui/ui/ui.h"
 #include "components/ui/ui/vars.h"
 #include "components/ui/ui/screens.h"
+#include "components/ui/ui/gauge.h"
+#include "components/ui/ui/static_layer.h"
+#include "components/ui/ui/digit_atlas.h"
@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -11,15 +14,108 @@
 #include "esp_lcd_panel_rgb.h"
 #include "esp_lcd_touch.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "lvgl.h"
+#include "src/draw/sw/lv_draw_sw.h"
 #include "lvgl_port.h"
+#include "lvgl_port_dirty.h"
+
+static const char *TAG = "lv_port";               // Tag for logging
+static SemaphoreHandle_t lvgl_mux;                // LVGL mutex for synchronization
+static TaskHandle_t lvgl_task_handle = NULL;      // Handle for the LVGL task
+static volatile bool lvgl_port_vsync_request;     // Set by the LVGL task to be woken on the next vsync
+static bool lvgl_port_suspended = false;          // Set while LVGL processing is suspended
+static esp_timer_handle_t lvgl_tick_timer = NULL; // Handle for the LVGL tick timer
+static volatile uint32_t lvgl_port_vsync_count;   // Number of vsyncs the blocking flushes have been notified of
+
+#if LVGL_PORT_FLUSH_ASYNC
+static lv_disp_drv_t *volatile lvgl_port_flush_drv = NULL; // Driver whose last flush is waiting for vsync
+#endif
 
-static const char *TAG = "lv_port";          // Tag for logging
-static SemaphoreHandle_t lvgl_mux;           // LVGL mutex for synchronization
-static TaskHandle_t lvgl_task_handle = NULL; // Handle for the LVGL task
+// Measurements of one frame, see `lvgl_port_stats_t`
+typedef struct
+{
+    uint32_t timer_handler_us;
+    uint32_t render_us;
+    uint32_t copy_us;
+    uint32_t copy_bytes;
+    uint32_t vsync_wait_us;
+    uint32_t flush_us;
+    bool full_copy;
+} lv_port_frame_stats_t;
+
+static lv_port_frame_stats_t stats_ring[LVGL_PORT_STATS_FRAMES]; // Recent frames, written by the LVGL task only
+static uint32_t stats_head = 0;                                  // Number of frames recorded in the ring
+static lv_port_frame_stats_t stats_frame = {0};                  // Frame being measured
+static int64_t stats_render_start = 0;                           // Start of the refresh of the frame being measured
+static bool stats_frame_flushed = false;                         // Whether the frame being measured was flushed
+
+// Function to record the frame being measured, if it was flushed, and start measuring the next one
+static void stats_commit(void)
+{
+    if (stats_frame_flushed)
+    {
+        stats_ring[stats_head % LVGL_PORT_STATS_FRAMES] = stats_frame;
+        __atomic_store_n(&stats_head, stats_head + 1, __ATOMIC_RELEASE); // Publish the record after it is written
+    }
+    memset(&stats_frame, 0, sizeof(stats_frame));
+    stats_frame_flushed = false;
+}
 
-#if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
+// Function to note the start of the last flush of a frame, returns the current time
+static inline int64_t stats_flush_begin(void)
+{
+    const int64_t now = esp_timer_get_time();
+    stats_frame.render_us = now - stats_render_start;
+    stats_frame_flushed = true;
+    return now;
+}
+
+// Function to note the end of the last flush of a frame
+static inline void stats_flush_end(int64_t start)
+{
+    stats_frame.flush_us = esp_timer_get_time() - start;
+}
+
+// Function to account a copy of `area` that started at `start`
+static inline void stats_copy(const lv_area_t *area, int64_t start)
+{
+    stats_frame.copy_us += esp_timer_get_time() - start;
+    stats_frame.copy_bytes += lv_area_get_size(area) * sizeof(lv_color_t);
+    stats_frame.full_copy |= (lv_area_get_size(area) == LVGL_PORT_H_RES * LVGL_PORT_V_RES);
+}
+
+// Function to wake the LVGL task for new work, unless it waits for the vsync it starts working at anyway
+static inline void lvgl_task_wake(void)
+{
+    if (lvgl_task_handle && !lvgl_port_vsync_request)
+    {
+        xTaskNotifyGive(lvgl_task_handle);
+    }
+}
+
+// Function to wait for the vsync ISR to notify that the current frame buffer has been transmitted
+static inline void flush_wait_vsync(void)
+{
+    const int64_t start = esp_timer_get_time();
+    const uint32_t vsync_count = lvgl_port_vsync_count;
+    ulTaskNotifyValueClear(NULL, ULONG_MAX);
+    do
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Posted UI commands may wake the task before the vsync
+    } while (lvgl_port_vsync_count == vsync_count);
+    stats_frame.vsync_wait_us += esp_timer_get_time() - start;
+}
+
+// LVGL's refresh timer callback, wrapped to note when a refresh starts
+static void refr_timer_callback(lv_timer_t *timer)
+{
+    stats_render_start = esp_timer_get_time();
+    _lv_disp_refr_timer(timer);
+}
+
+#if (EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0) && !LVGL_PORT_ROTATION_SCANOUT
 // Function to get the next frame buffer for double buffering
 static void *get_next_frame_buffer(esp_lcd_panel_handle_t panel_handle)
 {
@@ -38,152 +134,62 @@ static void *get_next_frame_buffer(esp_lcd_panel_handle_t panel_handle)
     return next_fb; // Return the next frame buffer
 }
 
-// Function to rotate and copy pixels from one buffer to another
-IRAM_ATTR static void rotate_copy_pixel(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
-{
-    int from_index = 0;     // Index for source buffer
-    int to_index = 0;       // Index for destination buffer
-    int to_index_const = 0; // Constant index for destination buffer
-
-    switch (rotation)
-    {
-    case 90:
-        to_index_const = (w - x_start - 1) * h; // Calculate constant index for 90-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++)
-        {
-            from_index = from_y * w + x_start;  // Calculate index in the source buffer
-            to_index = to_index_const + from_y; // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++)
-            {
-                *(to + to_index) = *(from + from_index); // Copy pixel
-                from_index += 1;                         // Move to the next pixel in the source
-                to_index -= h;                           // Move to the next pixel in the destination
-            }
-        }
-        break;
-    case 180:
-        to_index_const = h * w - x_start - 1; // Calculate constant index for 180-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++)
-        {
-            from_index = from_y * w + x_start;      // Calculate index in the source buffer
-            to_index = to_index_const - from_y * w; // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++)
-            {
-                *(to + to_index) = *(from + from_index); // Copy pixel
-                from_index += 1;                         // Move to the next pixel in the source
-                to_index -= 1;                           // Move to the next pixel in the destination
-            }
-        }
-        break;
-    case 270:
-        to_index_const = (x_start + 1) * h - 1; // Calculate constant index for 270-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++)
-        {
-            from_index = from_y * w + x_start;  // Calculate index in the source buffer
-            to_index = to_index_const - from_y; // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++)
-            {
-                *(to + to_index) = *(from + from_index); // Copy pixel
-                from_index += 1;                         // Move to the next pixel in the source
-                to_index += h;                           // Move to the next pixel in the destination
-            }
-        }
-        break;
-    default:
-        break; // Do nothing for unsupported rotation angles
-    }
-}
 #endif /* EXAMPLE_LVGL_PORT_ROTATION_DEGREE */
 
 #if LVGL_PORT_AVOID_TEAR_ENABLE
 #if LVGL_PORT_DIRECT_MODE
-#if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
+#if LVGL_PORT_ROTATION_SCANOUT
 
-// Structure to store information about dirty areas that need refreshing
-typedef struct
-{
-    uint16_t inv_p;                           // Number of invalid areas
-    uint8_t inv_area_joined[LV_INV_BUF_SIZE]; // Array to track joined invalid areas
-    lv_area_t inv_areas[LV_INV_BUF_SIZE];     // Array of invalid areas
-} lv_port_dirty_area_t;
-
-// Enumeration for flush status
-typedef enum
-{
-    FLUSH_STATUS_PART, // Partial flush
-    FLUSH_STATUS_FULL  // Full flush
-} lv_port_flush_status_t;
+static void *volatile lvgl_port_scanout_buf = NULL;      // Pointer for the buffer the bounce buffers are filled from
+static void *volatile lvgl_port_scanout_next_buf = NULL; // Pointer for the buffer to scan out from the next frame on
 
-// Enumeration for flush probe results
-typedef enum
-{
-    FLUSH_PROBE_PART_COPY, // Probe result for partial copy
-    FLUSH_PROBE_SKIP_COPY, // Probe result to skip copy
-    FLUSH_PROBE_FULL_COPY, // Probe result for full copy
-} lv_port_flush_probe_t;
-
-static lv_port_dirty_area_t dirty_area; // Instance of dirty area structure
-
-// Function to save the current dirty area information
-static void flush_dirty_save(lv_port_dirty_area_t *dirty_area)
+static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
-    lv_disp_t *disp = _lv_refr_get_disp_refreshing(); // Get the currently refreshing display
-    dirty_area->inv_p = disp->inv_p;                  // Save the number of invalid areas
-    for (int i = 0; i < disp->inv_p; i++)
+    /* Action after last area refresh */
+    if (lv_disp_flush_is_last(drv))
     {
-        dirty_area->inv_area_joined[i] = disp->inv_area_joined[i]; // Save joined areas status
-        dirty_area->inv_areas[i] = disp->inv_areas[i];             // Save invalid areas
+        const int64_t flush_start = stats_flush_begin();
+#if LVGL_PORT_FLUSH_ASYNC
+        /* Scan out `color_map` from the next frame on, the vsync ISR does the switch and completes the flush */
+        lvgl_port_scanout_next_buf = color_map;
+        stats_flush_end(flush_start);
+        lvgl_port_flush_drv = drv;
+        return;
+#else
+        /* Scan out `color_map` from the next frame on, the vsync ISR does the switch */
+        lvgl_port_scanout_next_buf = color_map;
+
+        /* Wait for the current frame buffer to complete transmission */
+        flush_wait_vsync();
+        stats_flush_end(flush_start);
+#endif
     }
+
+    lv_disp_flush_ready(drv); // Mark the display flush as complete
 }
 
-/**
- * @brief Probe dirty area to copy
- *
- * @note This function is used to avoid tearing effect, and only works with LVGL direct mode.
- *
- */
-static lv_port_flush_probe_t flush_copy_probe(lv_disp_drv_t *drv)
+IRAM_ATTR bool lvgl_port_fill_rgb_bounce_buffer(void *bounce_buf, int pos_px, int len_bytes)
 {
-    static lv_port_flush_status_t prev_status = FLUSH_STATUS_PART; // Previous flush status
-    lv_port_flush_status_t cur_status;                             // Current flush status
-    lv_port_flush_probe_t probe_result;                            // Result of the probe
-    lv_disp_t *disp_refr = _lv_refr_get_disp_refreshing();         // Get the currently refreshing display
+    const int len_px = len_bytes / sizeof(uint16_t); // Pixels in the bounce buffer
+    const uint16_t *fb = lvgl_port_scanout_buf;       // Frame buffer being scanned out
 
-    uint32_t flush_ver = 0; // Vertical size to flush
-    uint32_t flush_hor = 0; // Horizontal size to flush
-    for (int i = 0; i < disp_refr->inv_p; i++)
+    if (fb == NULL)
     {
-        if (disp_refr->inv_area_joined[i] == 0)
-        {
-            flush_ver = (disp_refr->inv_areas[i].y2 + 1 - disp_refr->inv_areas[i].y1); // Calculate vertical flush size
-            flush_hor = (disp_refr->inv_areas[i].x2 + 1 - disp_refr->inv_areas[i].x1); // Calculate horizontal flush size
-            break;                                                                     // Exit the loop after finding the first unjoined area
-        }
+        memset(bounce_buf, 0, len_bytes);
+        return false;
     }
-    /* Check if the current full screen refreshes */
-    cur_status = ((flush_ver == drv->ver_res) && (flush_hor == drv->hor_res)) ? (FLUSH_STATUS_FULL) : (FLUSH_STATUS_PART);
 
-    // Determine the probe result based on previous and current status
-    if (prev_status == FLUSH_STATUS_FULL)
-    {
-        if ((cur_status == FLUSH_STATUS_PART))
-        {
-            probe_result = FLUSH_PROBE_FULL_COPY; // Full copy needed
-        }
-        else
-        {
-            probe_result = FLUSH_PROBE_SKIP_COPY; // Skip copy
-        }
-    }
-    else
-    {
-        probe_result = FLUSH_PROBE_PART_COPY; // Partial copy needed
-    }
-    prev_status = cur_status; // Update previous status
+    /* Screen pixel `i` is frame buffer pixel `H_RES * V_RES - 1 - i`, copy the mirrored span reversed */
+    lvgl_port_rotate_reverse(fb + LVGL_PORT_H_RES * LVGL_PORT_V_RES - pos_px - len_px, bounce_buf, len_px);
 
-    return probe_result; // Return the result of the probe
+    return false;
 }
 
+#elif EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
+
+static lv_port_dirty_area_t dirty_area;      // Areas rendered in the last frame, missing from the frame buffer shown before it
+static lv_port_dirty_area_t dirty_copy_area; // Areas copied into the next frame buffer
+
 // Inline function to get the next buffer for flushing
 static inline void *flush_get_next_buf(void *panel_handle)
 {
@@ -201,17 +207,15 @@ static void flush_dirty_copy(void *dst, void *src, lv_port_dirty_area_t *dirty_a
     lv_coord_t x_start, x_end, y_start, y_end; // Coordinates for the area to be copied
     for (int i = 0; i < dirty_area->inv_p; i++)
     {
-        /* Refresh the unjoined areas */
-        if (dirty_area->inv_area_joined[i] == 0)
-        {
-            x_start = dirty_area->inv_areas[i].x1; // Start X coordinate
-            x_end = dirty_area->inv_areas[i].x2;   // End X coordinate
-            y_start = dirty_area->inv_areas[i].y1; // Start Y coordinate
-            y_end = dirty_area->inv_areas[i].y2;   // End Y coordinate
-
-            // Rotate and copy pixel data from source to destination buffer
-            rotate_copy_pixel(src, dst, x_start, y_start, x_end, y_end, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
-        }
+        x_start = dirty_area->inv_areas[i].x1; // Start X coordinate
+        x_end = dirty_area->inv_areas[i].x2;   // End X coordinate
+        y_start = dirty_area->inv_areas[i].y1; // Start Y coordinate
+        y_end = dirty_area->inv_areas[i].y2;   // End Y coordinate
+
+        // Rotate and copy pixel data from source to destination buffer
+        const int64_t copy_start = esp_timer_get_time();
+        lvgl_port_rotate_copy(src, dst, x_start, y_start, x_end, y_end, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+        stats_copy(&dirty_area->inv_areas[i], copy_start);
     }
 }
 
@@ -222,75 +226,36 @@ static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
     const int offsetx2 = area->x2;                                                // End X coordinate of the area to flush
     const int offsety1 = area->y1;                                                // Start Y coordinate of the area to flush
     const int offsety2 = area->y2;                                                // End Y coordinate of the area to flush
-    void *next_fb = NULL;                                                         // Pointer for the next frame buffer
-    lv_port_flush_probe_t probe_result = FLUSH_PROBE_PART_COPY;                   // Default probe result
-    lv_disp_t *disp = lv_disp_get_default();                                      // Get the default display
 
     /* Action after last area refresh */
     if (lv_disp_flush_is_last(drv))
     {
-        /* Check if the `full_refresh` flag has been triggered */
-        if (drv->full_refresh)
-        {
-            /* Reset flag */
-            drv->full_refresh = 0;
-
-            // Rotate and copy data from the whole screen LVGL's buffer to the next frame buffer
-            next_fb = flush_get_next_buf(panel_handle);
-            rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
-
-            /* Switch the current RGB frame buffer to `next_fb` */
-            esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
-
-            /* Wait for the current frame buffer to complete transmission */
-            ulTaskNotifyValueClear(NULL, ULONG_MAX);
-            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-
-            /* Synchronously update the dirty area for another frame buffer */
-            flush_dirty_copy(flush_get_next_buf(panel_handle), color_map, &dirty_area);
-            flush_get_next_buf(panel_handle);
-        }
-        else
-        {
-            /* Probe the copy method for the current dirty area */
-            probe_result = flush_copy_probe(drv);
-
-            if (probe_result == FLUSH_PROBE_FULL_COPY)
-            {
-                /* Save current dirty area for the next frame buffer */
-                flush_dirty_save(&dirty_area);
-
-                /* Set LVGL full-refresh flag and set flush ready in advance */
-                drv->full_refresh = 1;               // Indicate that a full refresh is required
-                disp->rendering_in_progress = false; // Mark rendering as not in progress
-                lv_disp_flush_ready(drv);            // Mark flush as ready
-
-                /* Force to refresh the whole screen, will invoke `flush_callback` recursively */
-                lv_refr_now(_lv_refr_get_disp_refreshing());
-            }
-            else
-            {
-                /* Update current dirty area for the next frame buffer */
-                next_fb = flush_get_next_buf(panel_handle);
-                flush_dirty_save(&dirty_area);
-                flush_dirty_copy(next_fb, color_map, &dirty_area);
-
-                /* Switch the current RGB frame buffer to `next_fb` */
-                esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
-
-                /* Wait for the current frame buffer to complete transmission */
-                ulTaskNotifyValueClear(NULL, ULONG_MAX);
-                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-
-                if (probe_result == FLUSH_PROBE_PART_COPY)
-                {
-                    /* Synchronously update the dirty area for another frame buffer */
-                    flush_dirty_save(&dirty_area);
-                    flush_dirty_copy(flush_get_next_buf(panel_handle), color_map, &dirty_area);
-                    flush_get_next_buf(panel_handle);
-                }
-            }
-        }
+        const int64_t flush_start = stats_flush_begin();
+
+        /*
+         * The next frame buffer was last shown two frames ago, so it misses the areas of the previous frame as well
+         * as the current one. LVGL's buffer holds the whole current frame, copy both sets from it in one pass.
+         */
+        dirty_copy_area = dirty_area;
+        lvgl_port_dirty_save(&dirty_area, _lv_refr_get_disp_refreshing());
+        lvgl_port_dirty_merge(&dirty_copy_area, &dirty_area, LV_HOR_RES, LV_VER_RES);
+
+        void *next_fb = flush_get_next_buf(panel_handle);
+        flush_dirty_copy(next_fb, color_map, &dirty_copy_area);
+
+        /* Switch the current RGB frame buffer to `next_fb` */
+        esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
+
+#if LVGL_PORT_FLUSH_ASYNC
+        /* The vsync ISR completes the flush once `next_fb` is being transmitted */
+        stats_flush_end(flush_start);
+        lvgl_port_flush_drv = drv;
+        return;
+#else
+        /* Wait for the current frame buffer to complete transmission */
+        flush_wait_vsync();
+        stats_flush_end(flush_start);
+#endif
     }
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
@@ -309,12 +274,21 @@ static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
     /* Action after last area refresh */
     if (lv_disp_flush_is_last(drv))
     {
+        const int64_t flush_start = stats_flush_begin();
+
         /* Switch the current RGB frame buffer to `color_map` */
         esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
 
+#if LVGL_PORT_FLUSH_ASYNC
+        /* The vsync ISR completes the flush once `color_map` is being transmitted */
+        stats_flush_end(flush_start);
+        lvgl_port_flush_drv = drv;
+        return;
+#else
         /* Wait for the last frame buffer to complete transmission */
-        ulTaskNotifyValueClear(NULL, ULONG_MAX);
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        flush_wait_vsync();
+        stats_flush_end(flush_start);
+#endif
     }
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
@@ -331,14 +305,22 @@ static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
     const int offsety1 = area->y1;                                                // Start Y coordinate of the area to flush
     const int offsety2 = area->y2;                                                // End Y coordinate of the area to flush
 
+    const int64_t flush_start = stats_flush_begin();
+
     /* Switch the current RGB frame buffer to `color_map` */
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
 
+#if LVGL_PORT_FLUSH_ASYNC
+    /* The vsync ISR completes the flush once `color_map` is being transmitted */
+    stats_flush_end(flush_start);
+    lvgl_port_flush_drv = drv;
+#else
     /* Wait for the last frame buffer to complete transmission */
-    ulTaskNotifyValueClear(NULL, ULONG_MAX);
-    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    flush_wait_vsync();
+    stats_flush_end(flush_start);
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
+#endif
 }
 
 #elif LVGL_PORT_FULL_REFRESH && LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3
@@ -357,11 +339,13 @@ void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color
     const int offsety1 = area->y1;                                                // Start Y coordinate of the area to flush
     const int offsety2 = area->y2;                                                // End Y coordinate of the area to flush
 
+    const int64_t flush_start = stats_flush_begin();
 #if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
     void *next_fb = get_next_frame_buffer(panel_handle); // Get the next frame buffer
 
     /* Rotate and copy dirty area from the current LVGL's buffer to the next RGB frame buffer */
-    rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+    lvgl_port_rotate_copy((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+    stats_copy(area, flush_start);
 
     /* Switch the current RGB frame buffer to `next_fb` */
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
@@ -375,6 +359,7 @@ void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color
 
     lvgl_port_rgb_next_buf = color_map; // Update the next RGB buffer
 #endif
+    stats_flush_end(flush_start);
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
 }
@@ -391,13 +376,91 @@ void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color
     const int offsety2 = area->y2;                                                // End Y coordinate of the area to flush
 
     /* Just copy data from the color map to the RGB frame buffer */
+    const int64_t copy_start = esp_timer_get_time();
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
+    stats_copy(area, copy_start);
+
+    /* Action after last area refresh */
+    if (lv_disp_flush_is_last(drv))
+    {
+        stats_flush_end(stats_flush_begin());
+    }
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
 }
 
 #endif /* LVGL_PORT_AVOID_TEAR_ENABLE */
 
+/*
+ * The software renderer blurs one corner of a shadow and mirrors it to the four corners and along the edges.
+ * lv_draw_sw_rect.c keeps the last corner in a static LV_SHADOW_CACHE_SIZE^2 buffer in internal SRAM, keyed by
+ * the corner size (shadow width + radius) and the radius, the radius clamped to half the short side of the
+ * spread shadow. The rectangle drawer of the draw context is wrapped to mirror that key and count hits. The
+ * cache itself is private to the renderer, so the hits and misses are an estimate from this model.
+ */
+static void (*shadow_sw_draw_rect)(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords);
+static int32_t shadow_cache_corner = -1;        // Corner size of the cached shadow corner
+static int32_t shadow_cache_radius = -1;        // Radius of the cached shadow corner
+static lvgl_port_shadow_stats_t shadow_stats;   // Written by the LVGL task only
+
+static void shadow_draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+    // Same conditions as the renderer for skipping the shadow
+    if (dsc->shadow_width == 0 || dsc->shadow_opa <= LV_OPA_MIN ||
+        (dsc->shadow_width == 1 && dsc->shadow_spread <= 0 && dsc->shadow_ofs_x == 0 && dsc->shadow_ofs_y == 0))
+    {
+        shadow_sw_draw_rect(draw_ctx, dsc, coords);
+        return;
+    }
+
+    lv_area_t core = *coords; // Rectangle that is blurred
+    lv_area_move(&core, dsc->shadow_ofs_x, dsc->shadow_ofs_y);
+    lv_area_increase(&core, dsc->shadow_spread, dsc->shadow_spread);
+    lv_area_t shadow = core;
+    lv_area_increase(&shadow, dsc->shadow_width / 2 + 1, dsc->shadow_width / 2 + 1);
+    lv_area_t draw_area;
+    if (!_lv_area_intersect(&draw_area, &shadow, draw_ctx->clip_area))
+    {
+        shadow_sw_draw_rect(draw_ctx, dsc, coords); // The shadow is clipped away, only the rectangle is drawn
+        return;
+    }
+
+    const lv_coord_t short_side = LV_MIN(lv_area_get_width(&core), lv_area_get_height(&core));
+    const int32_t radius = LV_MIN(dsc->radius, short_side >> 1);
+    const int32_t corner = dsc->shadow_width + radius;
+    if (corner == shadow_cache_corner && radius == shadow_cache_radius)
+    {
+        shadow_stats.hits++;
+    }
+    else
+    {
+        shadow_stats.misses++;
+        if (corner < LV_SHADOW_CACHE_SIZE) // The renderer caches it if it fits
+        {
+            shadow_cache_corner = corner;
+            shadow_cache_radius = radius;
+        }
+    }
+
+    const int64_t start = esp_timer_get_time();
+    shadow_sw_draw_rect(draw_ctx, dsc, coords);
+    shadow_stats.draws++;
+    shadow_stats.draw_us += esp_timer_get_time() - start;
+}
+
+static void draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    shadow_sw_draw_rect = draw_ctx->draw_rect;
+    draw_ctx->draw_rect = shadow_draw_rect;
+}
+
+void lvgl_port_get_shadow_stats(lvgl_port_shadow_stats_t *stats)
+{
+    assert(stats); // Ensure the output is valid
+    *stats = shadow_stats; // The counters may be a draw apart
+}
+
 static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
 {
     assert(panel_handle); // Ensure the panel handle is valid
@@ -414,7 +477,13 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
 #if LVGL_PORT_AVOID_TEAR_ENABLE
     // To avoid tearing effect, at least two frame buffers are needed: one for LVGL rendering and another for RGB output
     buffer_size = LVGL_PORT_H_RES * LVGL_PORT_V_RES;
-#if (LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3) && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0) && LVGL_PORT_FULL_REFRESH
+#if LVGL_PORT_ROTATION_SCANOUT
+    // The RGB driver owns no frame buffers, LVGL renders into two PSRAM buffers that are scanned out mirrored
+    buf1 = heap_caps_aligned_calloc(64, 1, buffer_size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    buf2 = heap_caps_aligned_calloc(64, 1, buffer_size * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
+    assert(buf1 && buf2);             // Ensure allocation succeeded
+    lvgl_port_scanout_buf = buf2;     // Scan out the blank buffer until the first frame is flushed
+#elif (LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3) && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0) && LVGL_PORT_FULL_REFRESH
     // With three buffers and full-refresh, one buffer is always available for rendering
     ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 3, &lvgl_port_rgb_last_buf, &buf1, &buf2));
     lvgl_port_rgb_next_buf = lvgl_port_rgb_last_buf; // Set the next RGB buffer
@@ -450,6 +519,7 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     disp_drv.flush_cb = flush_callback; // Set the flush callback
     disp_drv.draw_buf = &disp_buf;      // Set the draw buffer
     disp_drv.user_data = panel_handle;  // Set user data to panel handle
+    disp_drv.draw_ctx_init = draw_ctx_init; // Software renderer with the shadow counters
 #if LVGL_PORT_FULL_REFRESH
     disp_drv.full_refresh = 1; // Enable full refresh
 #elif LVGL_PORT_DIRECT_MODE
@@ -458,6 +528,101 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     return lv_disp_drv_register(&disp_drv); // Register the display driver
 }
 
+#if LVGL_PORT_TOUCH_INTERRUPT
+// One sample of the touch controller
+typedef struct
+{
+    uint16_t x;   // X coordinate
+    uint16_t y;   // Y coordinate
+    bool pressed; // Whether the panel is touched
+} lv_port_touch_sample_t;
+
+static lv_port_touch_sample_t touch_ring[LVGL_PORT_TOUCH_RING_SIZE]; // Samples read by the touch task, drained by LVGL
+static uint32_t touch_ring_head = 0;                                 // Number of samples pushed, written by the touch task only
+static uint32_t touch_ring_tail = 0;                                 // Number of samples popped, written by the LVGL task only
+static TaskHandle_t touch_task_handle = NULL;                        // Handle for the touch task
+static lv_timer_t *touch_read_timer = NULL;                          // LVGL input read timer, paused while the panel is released
+
+IRAM_ATTR void lvgl_port_notify_touch_interrupt(esp_lcd_touch_handle_t tp)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    if (touch_task_handle)
+    {
+        vTaskNotifyGiveFromISR(touch_task_handle, &need_yield); // Notify the touch task
+    }
+    portYIELD_FROM_ISR(need_yield);
+}
+
+static void touch_task(void *arg)
+{
+    esp_lcd_touch_handle_t tp = (esp_lcd_touch_handle_t)arg; // Touch panel handle
+    lv_port_touch_sample_t sample = {0};                     // Last sample queued for LVGL
+
+    while (1)
+    {
+        /* Sleep until the controller raises INT, polling slowly while touched in case the release edge is missed */
+        ulTaskNotifyTake(pdTRUE, sample.pressed ? pdMS_TO_TICKS(LVGL_PORT_TOUCH_RELEASE_POLL_MS) : portMAX_DELAY);
+
+        uint16_t touchpad_x;      // Variable for X coordinate
+        uint16_t touchpad_y;      // Variable for Y coordinate
+        uint8_t touchpad_cnt = 0; // Variable for touch count
+
+        esp_lcd_touch_read_data(tp); // Read data from touch controller
+        const bool pressed = esp_lcd_touch_get_coordinates(tp, &touchpad_x, &touchpad_y, NULL, &touchpad_cnt, 1) && (touchpad_cnt > 0);
+        if (!pressed && !sample.pressed)
+        {
+            continue; // Still released, nothing to report
+        }
+        if (pressed)
+        {
+            sample.x = touchpad_x; // A release is reported at the last touched point
+            sample.y = touchpad_y;
+        }
+        sample.pressed = pressed;
+
+        /* Wait for LVGL to drain the ring rather than drop a press or release */
+        while (touch_ring_head - __atomic_load_n(&touch_ring_tail, __ATOMIC_ACQUIRE) >= LVGL_PORT_TOUCH_RING_SIZE)
+        {
+            vTaskDelay(1);
+        }
+        touch_ring[touch_ring_head % LVGL_PORT_TOUCH_RING_SIZE] = sample;
+        __atomic_store_n(&touch_ring_head, touch_ring_head + 1, __ATOMIC_RELEASE); // Publish the sample after it is written
+
+        /* Let LVGL drain the ring, its input read timer only runs from a touch until the release is processed */
+        if (lvgl_port_lock(-1))
+        {
+            lv_timer_resume(touch_read_timer);
+            lv_timer_ready(touch_read_timer); // Read the sample on the next timer run rather than a read period later
+            lvgl_port_unlock();
+        }
+        lvgl_task_wake(); // The LVGL task may sleep until its next timer or be suspended
+    }
+}
+
+static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+    static lv_port_touch_sample_t sample = {0}; // Last sample reported, repeated while no new one is queued
+
+    const uint32_t head = __atomic_load_n(&touch_ring_head, __ATOMIC_ACQUIRE);
+    if (touch_ring_tail != head)
+    {
+        sample = touch_ring[touch_ring_tail % LVGL_PORT_TOUCH_RING_SIZE];
+        __atomic_store_n(&touch_ring_tail, touch_ring_tail + 1, __ATOMIC_RELEASE); // Free the slot after it is read
+        data->continue_reading = (touch_ring_tail != head);                        // Let LVGL drain every queued sample
+    }
+
+    data->point.x = sample.x;                                                        // Set the X coordinate
+    data->point.y = sample.y;                                                        // Set the Y coordinate
+    data->state = sample.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED; // Set the state
+
+    /* Stop polling once the release is read and a scroll it started has come to rest, the touch task resumes it */
+    if (!sample.pressed && (touch_ring_tail == head) && (lv_indev_get_scroll_obj(lv_indev_get_act()) == NULL))
+    {
+        lv_timer_pause(indev_drv->read_timer);
+    }
+}
+#else
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
     esp_lcd_touch_handle_t tp = (esp_lcd_touch_handle_t)indev_drv->user_data; // Get touchpad handle from user data
@@ -485,6 +650,8 @@ static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
     }
 }
 
+#endif /* LVGL_PORT_TOUCH_INTERRUPT */
+
 static lv_indev_t *indev_init(esp_lcd_touch_handle_t tp)
 {
     assert(tp); // Ensure the touch panel handle is valid
@@ -497,7 +664,27 @@ static lv_indev_t *indev_init(esp_lcd_touch_handle_t tp)
     indev_drv_tp.read_cb = touchpad_read;      // Set the read callback function
     indev_drv_tp.user_data = tp;               // Set user data to the touch panel handle
 
-    return lv_indev_drv_register(&indev_drv_tp); // Register the input device driver
+    lv_indev_t *indev = lv_indev_drv_register(&indev_drv_tp); // Register the input device driver
+#if LVGL_PORT_TOUCH_INTERRUPT
+    if (indev == NULL)
+    {
+        return NULL;
+    }
+
+    /* Read the touch controller from its own task, the LVGL input poll only drains the queued samples */
+    touch_read_timer = indev->driver->read_timer;
+    lv_timer_pause(touch_read_timer); // Nothing to drain until the first touch
+    BaseType_t core_id = (LVGL_PORT_TASK_CORE < 0) ? tskNO_AFFINITY : LVGL_PORT_TASK_CORE; // Determine core ID for the task
+    BaseType_t ret = xTaskCreatePinnedToCore(touch_task, "touch", LVGL_PORT_TOUCH_TASK_STACK_SIZE, tp,
+                                             LVGL_PORT_TASK_PRIORITY, &touch_task_handle, core_id); // Create the touch task
+    if (ret != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create touch task"); // Log error if task creation fails
+        return NULL;                                  // Return failure
+    }
+#endif
+
+    return indev;
 }
 
 static void tick_increment(void *arg)
@@ -513,44 +700,224 @@ static esp_err_t tick_init(void)
         .callback = &tick_increment, // Set the callback function for the timer
         .name = "LVGL tick"          // Name of the timer
     };
-    esp_timer_handle_t lvgl_tick_timer = NULL;                                         // Timer handle
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));        // Create the timer
     return esp_timer_start_periodic(lvgl_tick_timer, LVGL_PORT_TICK_PERIOD_MS * 1000); // Start the timer
 }
 
+// Check whether any area is waiting to be refreshed
+static inline bool refresh_pending(void)
+{
+    lv_disp_t *disp = lv_disp_get_default(); // Get the default display
+    return disp && disp->inv_p != 0;
+}
+
+// Function to read all input devices without running the other LVGL timers
+static void read_input(void)
+{
+    lv_indev_t *indev = NULL; // Input device being read
+    while ((indev = lv_indev_get_next(indev)) != NULL)
+    {
+        lv_indev_read_timer_cb(indev->driver->read_timer);
+    }
+}
+
+// One UI command, see `lvgl_port_post_*()`
+typedef struct
+{
+    uint8_t type;  // Command type
+    lv_obj_t *obj; // Object the command applies to
+    union
+    {
+        char text[LVGL_PORT_CMD_TEXT_SIZE]; // Label text
+        int16_t value;                      // Arc value
+        struct
+        {
+            lvgl_port_cmd_cb_t cb; // Function to call
+            void *user_data;       // Argument of the function
+        } call;
+    };
+} lv_port_cmd_t;
+
+enum
+{
+    LV_PORT_CMD_LABEL_TEXT,
+    LV_PORT_CMD_ARC_VALUE,
+    LV_PORT_CMD_LOAD_SCREEN,
+    LV_PORT_CMD_CALL,
+};
+
+// Slot of the command queue, `seq` tells whether it is free for the producer or filled for the consumer
+typedef struct
+{
+    uint32_t seq;
+    lv_port_cmd_t cmd;
+} lv_port_cmd_slot_t;
+
+static lv_port_cmd_slot_t cmd_queue[LVGL_PORT_CMD_QUEUE_SIZE]; // Bounded multi-producer, single-consumer queue
+static uint32_t cmd_queue_head = 0;                            // Commands claimed by producers
+static uint32_t cmd_queue_tail = 0;                            // Commands executed, written by the LVGL task only
+static uint32_t cmd_queue_max_depth = 0;                       // Highest number of waiting commands seen
+static uint32_t cmd_queue_posted = 0;                          // Commands posted
+static uint32_t cmd_queue_dropped = 0;                         // Commands dropped because the queue was full
+
+static void cmd_queue_init(void)
+{
+    for (uint32_t i = 0; i < LVGL_PORT_CMD_QUEUE_SIZE; i++)
+    {
+        cmd_queue[i].seq = i; // Every slot is free for its first round
+    }
+}
+
+// Function to post a command from any task without taking the LVGL mutex
+static bool cmd_queue_post(const lv_port_cmd_t *cmd)
+{
+    lv_port_cmd_slot_t *slot;                                          // Slot claimed for the command
+    uint32_t pos = __atomic_load_n(&cmd_queue_head, __ATOMIC_RELAXED); // Position to claim
+    while (1)
+    {
+        slot = &cmd_queue[pos % LVGL_PORT_CMD_QUEUE_SIZE];
+        const int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {
+            // The slot is free, claim it unless another producer was faster
+            if (__atomic_compare_exchange_n(&cmd_queue_head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            __atomic_fetch_add(&cmd_queue_dropped, 1, __ATOMIC_RELAXED); // The LVGL task has not freed the slot yet
+            return false;
+        }
+        else
+        {
+            pos = __atomic_load_n(&cmd_queue_head, __ATOMIC_RELAXED); // Another producer claimed the slot
+        }
+    }
+
+    slot->cmd = *cmd;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE); // Hand the slot to the LVGL task
+    __atomic_fetch_add(&cmd_queue_posted, 1, __ATOMIC_RELAXED);
+
+    lvgl_task_wake(); // Wake the LVGL task to execute the command
+    return true;
+}
+
+// Function to execute the queued commands, called by the LVGL task with the LVGL mutex held
+static void cmd_queue_drain(void)
+{
+    const uint32_t depth = __atomic_load_n(&cmd_queue_head, __ATOMIC_RELAXED) - cmd_queue_tail;
+    cmd_queue_max_depth = LV_MAX(cmd_queue_max_depth, LV_MIN(depth, LVGL_PORT_CMD_QUEUE_SIZE));
+
+    while (1)
+    {
+        lv_port_cmd_slot_t *slot = &cmd_queue[cmd_queue_tail % LVGL_PORT_CMD_QUEUE_SIZE];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != cmd_queue_tail + 1)
+        {
+            break; // Empty, or the producer has not finished writing the command
+        }
+        const lv_port_cmd_t cmd = slot->cmd;
+        __atomic_store_n(&slot->seq, cmd_queue_tail + LVGL_PORT_CMD_QUEUE_SIZE, __ATOMIC_RELEASE); // Free the slot
+        cmd_queue_tail++;
+
+        switch (cmd.type)
+        {
+        case LV_PORT_CMD_LABEL_TEXT:
+            lv_label_set_text(cmd.obj, cmd.text);
+            break;
+        case LV_PORT_CMD_ARC_VALUE:
+            lv_arc_set_value(cmd.obj, cmd.value);
+            break;
+        case LV_PORT_CMD_LOAD_SCREEN:
+            lv_scr_load(cmd.obj);
+            break;
+        case LV_PORT_CMD_CALL:
+            cmd.call.cb(cmd.call.user_data);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 static void lvgl_port_task(void *arg)
 {
     ESP_LOGD(TAG, "Starting LVGL task"); // Log the task start
 
-    uint32_t task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS; // Set initial task delay
+    uint32_t task_delay_ms = 0; // Time until the next LVGL timer is due
     while (1)
     {
-        if (lvgl_port_lock(-1))
-        {                                       // Try to lock the LVGL mutex
-            task_delay_ms = lv_timer_handler(); // Handle LVGL timer events
-            lvgl_port_unlock();                 // Unlock the mutex
+#if LVGL_PORT_FLUSH_ASYNC
+        /* Wait for the vsync ISR to complete the last flush before rendering again, without holding the mutex */
+        const int64_t wait_start = esp_timer_get_time();
+        while (lvgl_port_flush_drv != NULL)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         }
-        // Ensure the delay time is within limits
-        if (task_delay_ms > LVGL_PORT_TASK_MAX_DELAY_MS)
+        stats_frame.vsync_wait_us += esp_timer_get_time() - wait_start;
+#endif
+        stats_commit(); // Record the frame rendered by the last `lv_timer_handler` call, if any
+
+        /* While suspended, only process input so a touch can still wake the UI, and render nothing */
+        while (lvgl_port_is_suspended())
         {
-            task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS;
+            ulTaskNotifyTake(pdTRUE, LVGL_PORT_TOUCH_INTERRUPT ? portMAX_DELAY : pdMS_TO_TICKS(LV_INDEV_DEF_READ_PERIOD));
+            if (lvgl_port_is_suspended() && lvgl_port_lock(-1))
+            {
+                cmd_queue_drain(); // Execute the posted UI commands, what they invalidate is drawn on resume
+                read_input();      // Read the input devices
+                lvgl_port_unlock();
+            }
         }
-        else if (task_delay_ms < LVGL_PORT_TASK_MIN_DELAY_MS)
+
+        if (lvgl_port_lock(-1))
+        {                                                                        // Try to lock the LVGL mutex
+            const int64_t handler_start = esp_timer_get_time();                  // Start of the LVGL timer handling
+            cmd_queue_drain();                                                   // Execute the posted UI commands
+            task_delay_ms = lv_timer_handler();                                  // Handle LVGL timer events
+            stats_frame.timer_handler_us = esp_timer_get_time() - handler_start; // Duration of the LVGL timer handling
+            lvgl_port_unlock();                                                  // Unlock the mutex
+        }
+
+        /* Sleep until the next LVGL timer is due, or indefinitely, unless a producer invalidates an area */
+        const TickType_t wait_ticks = (task_delay_ms == LV_NO_TIMER_READY) ? portMAX_DELAY : LV_MAX(pdMS_TO_TICKS(task_delay_ms), 1);
+        ulTaskNotifyTake(pdTRUE, wait_ticks);
+
+        /* Start pending refreshes right after a vsync, so rendering gets a whole frame period */
+        if (refresh_pending())
         {
-            task_delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS;
+            /* Commands and touches don't notify the task while the request is set, only the ISR clears it */
+            const TickType_t vsync_timeout = pdMS_TO_TICKS(LVGL_PORT_VSYNC_TIMEOUT_MS);
+            const TickType_t vsync_start = xTaskGetTickCount();
+            TickType_t waited = 0;
+            lvgl_port_vsync_request = true;
+            while (lvgl_port_vsync_request && (waited = xTaskGetTickCount() - vsync_start) < vsync_timeout)
+            {
+                ulTaskNotifyTake(pdTRUE, vsync_timeout - waited);
+            }
+            lvgl_port_vsync_request = false;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms)); // Delay the task for the calculated time
     }
 }
 
 esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle_t tp_handle)
 {
     lv_init();                    // Initialize LVGL
+    cmd_queue_init();             // Initialize the UI command queue
     ESP_ERROR_CHECK(tick_init()); // Initialize the tick timer
 
+    lvgl_mux = xSemaphoreCreateRecursiveMutex(); // Create a recursive mutex for LVGL, the touch task takes it from its first touch
+    assert(lvgl_mux);                            // Ensure mutex creation was successful
+
     lv_disp_t *disp = display_init(lcd_handle); // Initialize the display
     assert(disp);                               // Ensure the display initialization was successful
 
+    /* Limit the refresh rate, LVGL's refresh timer is paused while nothing is invalidated */
+    lv_timer_t *refr_timer = _lv_disp_get_refr_timer(disp);
+    lv_timer_set_period(refr_timer, 1000 / LVGL_PORT_MAX_FPS);
+    lv_timer_set_cb(refr_timer, refr_timer_callback); // Note when each refresh starts for the statistics
+
     if (tp_handle)
     {
         lv_indev_t *indev = indev_init(tp_handle); // Initialize the touchpad input device
@@ -569,9 +936,6 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
 #endif
     }
 
-    lvgl_mux = xSemaphoreCreateRecursiveMutex(); // Create a recursive mutex for LVGL
-    assert(lvgl_mux);                            // Ensure mutex creation was successful
-
     ESP_LOGI(TAG, "Create LVGL task");                                                     // Log task creation
     BaseType_t core_id = (LVGL_PORT_TASK_CORE < 0) ? tskNO_AFFINITY : LVGL_PORT_TASK_CORE; // Determine core ID for the task
     BaseType_t ret = xTaskCreatePinnedToCore(lvgl_port_task, "lvgl", LVGL_PORT_TASK_STACK_SIZE, NULL,
@@ -596,12 +960,28 @@ bool lvgl_port_lock(int timeout_ms)
 void lvgl_port_unlock(void)
 {
     assert(lvgl_mux && "lvgl_port_init must be called first"); // Ensure the mutex is initialized
-    xSemaphoreGiveRecursive(lvgl_mux);                         // Release the mutex
+
+    // Wake the LVGL task to refresh what another task invalidated, once it releases the mutex for the last time
+    const TaskHandle_t current_task = xTaskGetCurrentTaskHandle();
+    const bool wake_lvgl_task = (current_task != lvgl_task_handle) && !lvgl_port_is_suspended() && refresh_pending();
+
+    xSemaphoreGiveRecursive(lvgl_mux); // Release the mutex
+
+    if (wake_lvgl_task && (xSemaphoreGetMutexHolder(lvgl_mux) != current_task))
+    {
+        lvgl_task_wake(); // Notify the LVGL task
+    }
 }
 
 bool lvgl_port_notify_rgb_vsync(void)
 {
     BaseType_t need_yield = pdFALSE; // Flag to check if a yield is needed
+    if (lvgl_port_vsync_request)
+    {
+        // The LVGL task waits for this vsync to start a refresh
+        lvgl_port_vsync_request = false;
+        vTaskNotifyGiveFromISR(lvgl_task_handle, &need_yield); // Notify the LVGL task
+    }
 #if LVGL_PORT_FULL_REFRESH && (LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3) && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0)
     if (lvgl_port_rgb_next_buf != lvgl_port_rgb_last_buf)
     {
@@ -609,8 +989,182 @@ bool lvgl_port_notify_rgb_vsync(void)
         lvgl_port_rgb_last_buf = lvgl_port_rgb_next_buf;   // Update the last buffer
     }
 #elif LVGL_PORT_AVOID_TEAR_ENABLE
+#if LVGL_PORT_ROTATION_SCANOUT
+    if (lvgl_port_scanout_next_buf != NULL)
+    {
+        lvgl_port_scanout_buf = lvgl_port_scanout_next_buf; // Scan out the flushed buffer from this frame on
+        lvgl_port_scanout_next_buf = NULL;
+    }
+#endif
+#if LVGL_PORT_FLUSH_ASYNC
+    lv_disp_drv_t *drv = lvgl_port_flush_drv;
+    if (drv != NULL)
+    {
+        // The flushed frame buffer is now being transmitted, LVGL may render into the other one
+        lvgl_port_flush_drv = NULL;
+        lv_disp_flush_ready(drv);
+        vTaskNotifyGiveFromISR(lvgl_task_handle, &need_yield); // Notify the LVGL task
+    }
+#else
     // Notify that the current RGB frame buffer has been transmitted
+    lvgl_port_vsync_count++;
     xTaskNotifyFromISR(lvgl_task_handle, ULONG_MAX, eNoAction, &need_yield); // Notify the LVGL task
+#endif
 #endif
     return (need_yield == pdTRUE); // Return whether a yield is needed
 }
+
+// Comparison function for sorting measurements
+static int stats_compare(const void *a, const void *b)
+{
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to aggregate `count` measurements, sorting them in place
+static void stats_aggregate(lvgl_port_stat_t *stat, uint32_t *values, uint32_t count)
+{
+    uint64_t sum = 0; // Sum of the measurements
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sum += values[i];
+    }
+    qsort(values, count, sizeof(uint32_t), stats_compare);
+
+    stat->min = values[0];
+    stat->avg = sum / count;
+    stat->p99 = values[(count * 99 + 99) / 100 - 1]; // Smallest value not exceeded by 99% of the frames
+    stat->max = values[count - 1];
+}
+
+// Function to compute the statistics from a copy of the ring, `values` is scratch space for one measurement per frame
+static void stats_collect(lvgl_port_stats_t *stats, lv_port_frame_stats_t *frames, uint32_t *values)
+{
+    /*
+     * Copy the ring while the LVGL task keeps recording, then keep only the records it could not have overwritten
+     * meanwhile: the ones older than the copy started and newer than the slot being written when it ended.
+     */
+    const uint32_t head = __atomic_load_n(&stats_head, __ATOMIC_ACQUIRE);
+    memcpy(frames, stats_ring, sizeof(stats_ring));
+    const uint32_t last_head = __atomic_load_n(&stats_head, __ATOMIC_ACQUIRE);
+
+    uint32_t first = (head > LVGL_PORT_STATS_FRAMES) ? head - LVGL_PORT_STATS_FRAMES : 0; // Oldest valid record
+    if (last_head + 1 > LVGL_PORT_STATS_FRAMES)
+    {
+        first = LV_MAX(first, last_head + 1 - LVGL_PORT_STATS_FRAMES);
+    }
+    const uint32_t count = (head > first) ? head - first : 0; // Number of valid records
+
+    stats->frames = head;
+    stats->samples = count;
+    if (count == 0)
+    {
+        return;
+    }
+
+#define STATS_AGGREGATE(field)                                              \
+    do                                                                      \
+    {                                                                       \
+        for (uint32_t i = 0; i < count; i++)                                \
+        {                                                                   \
+            values[i] = frames[(first + i) % LVGL_PORT_STATS_FRAMES].field; \
+        }                                                                   \
+        stats_aggregate(&stats->field, values, count);                      \
+    } while (0)
+
+    STATS_AGGREGATE(timer_handler_us);
+    STATS_AGGREGATE(render_us);
+    STATS_AGGREGATE(copy_us);
+    STATS_AGGREGATE(copy_bytes);
+    STATS_AGGREGATE(vsync_wait_us);
+    STATS_AGGREGATE(flush_us);
+#undef STATS_AGGREGATE
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        stats->full_copies += frames[(first + i) % LVGL_PORT_STATS_FRAMES].full_copy;
+    }
+}
+
+void lvgl_port_get_stats(lvgl_port_stats_t *stats)
+{
+    assert(stats); // Ensure the output is valid
+    memset(stats, 0, sizeof(lvgl_port_stats_t));
+
+    lv_port_frame_stats_t *frames = malloc(sizeof(stats_ring));           // Copy of the ring
+    uint32_t *values = malloc(LVGL_PORT_STATS_FRAMES * sizeof(uint32_t)); // One measurement of every copied frame
+    if (frames && values)
+    {
+        stats_collect(stats, frames, values);
+    }
+    else
+    {
+        ESP_LOGE(TAG, "No memory for the rendering statistics"); // Log error if allocation fails
+    }
+    free(frames);
+    free(values);
+}
+
+void lvgl_port_suspend(void)
+{
+    if (__atomic_exchange_n(&lvgl_port_suspended, true, __ATOMIC_ACQ_REL))
+    {
+        return; // Already suspended
+    }
+    ESP_ERROR_CHECK(esp_timer_stop(lvgl_tick_timer)); // Stop the tick timer
+    ESP_LOGD(TAG, "LVGL suspended");
+}
+
+void lvgl_port_resume(void)
+{
+    if (!__atomic_exchange_n(&lvgl_port_suspended, false, __ATOMIC_ACQ_REL))
+    {
+        return; // Not suspended
+    }
+    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_PORT_TICK_PERIOD_MS * 1000)); // Restart the tick timer
+    xTaskNotifyGive(lvgl_task_handle); // Wake the LVGL task to refresh what was invalidated while suspended
+    ESP_LOGD(TAG, "LVGL resumed");
+}
+
+bool lvgl_port_is_suspended(void)
+{
+    return __atomic_load_n(&lvgl_port_suspended, __ATOMIC_ACQUIRE);
+}
+
+bool lvgl_port_post_label_text(lv_obj_t *label, const char *text)
+{
+    lv_port_cmd_t cmd = {.type = LV_PORT_CMD_LABEL_TEXT, .obj = label};
+    strlcpy(cmd.text, text, sizeof(cmd.text)); // Longer texts are truncated
+    return cmd_queue_post(&cmd);
+}
+
+bool lvgl_port_post_arc_value(lv_obj_t *arc, int16_t value)
+{
+    const lv_port_cmd_t cmd = {.type = LV_PORT_CMD_ARC_VALUE, .obj = arc, .value = value};
+    return cmd_queue_post(&cmd);
+}
+
+bool lvgl_port_post_load_screen(lv_obj_t *screen)
+{
+    const lv_port_cmd_t cmd = {.type = LV_PORT_CMD_LOAD_SCREEN, .obj = screen};
+    return cmd_queue_post(&cmd);
+}
+
+bool lvgl_port_post_call(lvgl_port_cmd_cb_t cb, void *user_data)
+{
+    assert(cb); // Ensure the function is valid
+    const lv_port_cmd_t cmd = {.type = LV_PORT_CMD_CALL, .call = {.cb = cb, .user_data = user_data}};
+    return cmd_queue_post(&cmd);
+}
+
+void lvgl_port_get_queue_stats(lvgl_port_queue_stats_t *stats)
+{
+    assert(stats); // Ensure the output is valid
+    const uint32_t tail = __atomic_load_n(&cmd_queue_tail, __ATOMIC_RELAXED);
+    const uint32_t head = __atomic_load_n(&cmd_queue_head, __ATOMIC_RELAXED);
+    stats->depth = LV_MIN(head - tail, LVGL_PORT_CMD_QUEUE_SIZE);
+    stats->max_depth = __atomic_load_n(&cmd_queue_max_depth, __ATOMIC_RELAXED);
+    stats->posted = __atomic_load_n(&cmd_queue_posted, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&cmd_queue_dropped, __ATOMIC_RELAXED);
+}
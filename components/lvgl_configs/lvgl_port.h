@@ -12,6 +12,7 @@
 #include "esp_lcd_types.h"
 #include "esp_lcd_touch.h"
 #include "lvgl.h"
+#include "lvgl_port_rotate.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -38,12 +39,25 @@ extern "C"
  * LVGL timer handle task related parameters, can be adjusted by users
  *
  */
-#define LVGL_PORT_TASK_MAX_DELAY_MS (CONFIG_EXAMPLE_LVGL_PORT_TASK_MAX_DELAY_MS)       // The maximum delay of the LVGL timer task, in milliseconds
-#define LVGL_PORT_TASK_MIN_DELAY_MS (CONFIG_EXAMPLE_LVGL_PORT_TASK_MIN_DELAY_MS)       // The minimum delay of the LVGL timer task, in milliseconds
+#define LVGL_PORT_MAX_FPS (CONFIG_EXAMPLE_LVGL_PORT_MAX_FPS)                           // The maximum refresh rate of the display, in frames per second
+#define LVGL_PORT_VSYNC_TIMEOUT_MS (100)                                               // The longest wait for a vsync before refreshing anyway, in milliseconds
 #define LVGL_PORT_TASK_STACK_SIZE (CONFIG_EXAMPLE_LVGL_PORT_TASK_STACK_SIZE_KB * 1024) // The stack size of the LVGL timer task, in bytes
 #define LVGL_PORT_TASK_PRIORITY (CONFIG_EXAMPLE_LVGL_PORT_TASK_PRIORITY)               // The priority of the LVGL timer task
 #define LVGL_PORT_TASK_CORE (CONFIG_EXAMPLE_LVGL_PORT_TASK_CORE)                       // The core of the LVGL timer task,
 // `-1` means the don't specify the core
+
+/**
+ * Touch related parameters, can be adjusted by users
+ *
+ */
+#ifdef CONFIG_EXAMPLE_LVGL_PORT_TOUCH_INTERRUPT
+#define LVGL_PORT_TOUCH_INTERRUPT (1) // Read the touch controller only when its INT line fires
+#else
+#define LVGL_PORT_TOUCH_INTERRUPT (0)
+#endif
+#define LVGL_PORT_TOUCH_TASK_STACK_SIZE (3 * 1024) // The stack size of the touch task, in bytes
+#define LVGL_PORT_TOUCH_RING_SIZE (16)             // Touch samples queued for LVGL, a power of two
+#define LVGL_PORT_TOUCH_RELEASE_POLL_MS (100)      // While touched, read at least this often in case the release interrupt is missed
 /**
  *
  * LVGL buffer related parameters, can be adjusted by users:
@@ -113,7 +127,15 @@ extern "C"
 #elif EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 270
 #define EXAMPLE_LVGL_PORT_ROTATION_270 (1)
 #endif
-#ifdef LVGL_PORT_LCD_RGB_BUFFER_NUMS
+/**
+ * With 180 degree rotation in direct mode the RGB bounce buffers can be filled in reverse order straight from
+ * the buffer LVGL renders into, so no rotated copy (and no third frame buffer) is needed.
+ *
+ */
+#if defined(CONFIG_EXAMPLE_LVGL_PORT_ROTATION_SCANOUT) && EXAMPLE_LVGL_PORT_ROTATION_180 && LVGL_PORT_DIRECT_MODE
+#define LVGL_PORT_ROTATION_SCANOUT (1)
+#endif
+#if defined(LVGL_PORT_LCD_RGB_BUFFER_NUMS) && !defined(LVGL_PORT_ROTATION_SCANOUT)
 #undef LVGL_PORT_LCD_RGB_BUFFER_NUMS
 #define LVGL_PORT_LCD_RGB_BUFFER_NUMS (3)
 #endif
@@ -124,6 +146,88 @@ extern "C"
 #define LVGL_PORT_DIRECT_MODE (0)
 #endif /* LVGL_PORT_AVOID_TEAR_ENABLE */
 
+#ifndef LVGL_PORT_ROTATION_SCANOUT
+#define LVGL_PORT_ROTATION_SCANOUT (0)
+#endif
+
+/**
+ * Return from the flush callback right after handing the frame buffer to the RGB driver and let the vsync ISR
+ * complete the flush, so the LVGL task does not hold the LVGL mutex while waiting for vsync.
+ * Only the direct mode and the double-buffered full-refresh mode support it.
+ *
+ */
+#if defined(CONFIG_EXAMPLE_LVGL_PORT_FLUSH_ASYNC) && \
+    (LVGL_PORT_DIRECT_MODE || (LVGL_PORT_FULL_REFRESH && LVGL_PORT_LCD_RGB_BUFFER_NUMS == 2))
+#define LVGL_PORT_FLUSH_ASYNC (1)
+#else
+#define LVGL_PORT_FLUSH_ASYNC (0)
+#endif
+
+#define LVGL_PORT_STATS_FRAMES (128) // Number of recent frames the rendering statistics are computed over
+
+#define LVGL_PORT_CMD_QUEUE_SIZE (32) // Number of UI commands that can wait for the LVGL task, a power of two
+#define LVGL_PORT_CMD_TEXT_SIZE (48)  // Longest label text a UI command carries, including the terminator
+
+    /**
+     * @brief Function called by the LVGL task for `lvgl_port_post_call()`
+     *
+     */
+    typedef void (*lvgl_port_cmd_cb_t)(void *user_data);
+
+    /**
+     * @brief Counters of the UI command queue
+     *
+     */
+    typedef struct
+    {
+        uint32_t depth;     // Commands waiting for the LVGL task
+        uint32_t max_depth; // Highest number of waiting commands seen by the LVGL task
+        uint32_t posted;    // Commands posted since start-up
+        uint32_t dropped;   // Commands dropped because the queue was full
+    } lvgl_port_queue_stats_t;
+
+    /**
+     * @brief Counters of the shadow corner cache of the software renderer
+     *
+     * @note The hits and misses are estimated by mirroring the renderer's cache key, the cache isn't visible
+     */
+    typedef struct
+    {
+        uint32_t hits;    // Shadows drawn from the cached corner, estimated
+        uint32_t misses;  // Shadows whose corner was blurred again, estimated
+        uint32_t draws;   // Rectangles drawn with a visible shadow
+        uint32_t draw_us; // Time spent drawing them, shadow and the rest of the rectangle
+    } lvgl_port_shadow_stats_t;
+
+    /**
+     * @brief Aggregate of one per-frame measurement over the recent frames
+     *
+     */
+    typedef struct
+    {
+        uint32_t min; // Smallest value
+        uint32_t avg; // Mean value
+        uint32_t p99; // 99th percentile
+        uint32_t max; // Largest value
+    } lvgl_port_stat_t;
+
+    /**
+     * @brief Rendering statistics of the recent frames
+     *
+     */
+    typedef struct
+    {
+        uint32_t frames;                   // Frames flushed since start-up
+        uint32_t samples;                  // Recent frames the aggregates are computed over
+        uint32_t full_copies;              // Recent frames whose copy covered the whole screen
+        lvgl_port_stat_t timer_handler_us; // Duration of the `lv_timer_handler` call that rendered the frame
+        lvgl_port_stat_t render_us;        // From the start of the refresh to the last flush
+        lvgl_port_stat_t copy_us;          // Time spent rotating or copying pixels in the flush callback
+        lvgl_port_stat_t copy_bytes;       // Bytes copied in the flush callback
+        lvgl_port_stat_t vsync_wait_us;    // Time spent waiting for the frame buffer to be transmitted
+        lvgl_port_stat_t flush_us;         // Duration of the last flush callback, including a blocking vsync wait
+    } lvgl_port_stats_t;
+
     /**
      * @brief Initialize LVGL port
      *
@@ -151,9 +255,108 @@ extern "C"
     /**
      * @brief Give LVGL mutex
      *
+     * @note Wakes the LVGL task if the caller invalidated any area while holding the mutex.
+     *
      */
     void lvgl_port_unlock(void);
 
+    /**
+     * @brief Queue setting the text of a label
+     *
+     * @note The `lvgl_port_post_*()` functions can be called from any task without taking the LVGL mutex, they never
+     *       block. The LVGL task executes the commands in order before its next `lv_timer_handler` call.
+     *
+     * @param[in] label: Label object
+     * @param[in] text: Text, copied and truncated to `LVGL_PORT_CMD_TEXT_SIZE - 1` characters
+     *
+     * @return
+     *      - true:  The command was queued
+     *      - false: The queue was full and the command was dropped
+     */
+    bool lvgl_port_post_label_text(lv_obj_t *label, const char *text);
+
+    /**
+     * @brief Queue setting the value of an arc
+     *
+     * @param[in] arc: Arc object
+     * @param[in] value: New value
+     *
+     * @return
+     *      - true:  The command was queued
+     *      - false: The queue was full and the command was dropped
+     */
+    bool lvgl_port_post_arc_value(lv_obj_t *arc, int16_t value);
+
+    /**
+     * @brief Queue loading a screen
+     *
+     * @param[in] screen: Screen object
+     *
+     * @return
+     *      - true:  The command was queued
+     *      - false: The queue was full and the command was dropped
+     */
+    bool lvgl_port_post_load_screen(lv_obj_t *screen);
+
+    /**
+     * @brief Queue a call of `cb` by the LVGL task, with the LVGL mutex held
+     *
+     * @param[in] cb: Function to call
+     * @param[in] user_data: Argument of the function
+     *
+     * @return
+     *      - true:  The command was queued
+     *      - false: The queue was full and the command was dropped
+     */
+    bool lvgl_port_post_call(lvgl_port_cmd_cb_t cb, void *user_data);
+
+    /**
+     * @brief Get the counters of the UI command queue
+     *
+     * @param[out] stats: Counters
+     */
+    void lvgl_port_get_queue_stats(lvgl_port_queue_stats_t *stats);
+
+    /**
+     * @brief Get the counters of the shadow corner cache
+     *
+     * @param[out] stats: Counters
+     */
+    void lvgl_port_get_shadow_stats(lvgl_port_shadow_stats_t *stats);
+
+    /**
+     * @brief Suspend LVGL processing, e.g. while the backlight is off
+     *
+     * @note Stops the LVGL tick and rendering. Input devices are still read, so a touch can resume the UI.
+     *       Areas invalidated while suspended are refreshed at once on resume.
+     *
+     */
+    void lvgl_port_suspend(void);
+
+    /**
+     * @brief Resume LVGL processing after `lvgl_port_suspend()`
+     *
+     */
+    void lvgl_port_resume(void);
+
+    /**
+     * @brief Check whether LVGL processing is suspended
+     *
+     * @return
+     *      - true:  LVGL processing is suspended
+     *      - false: LVGL processing is running
+     */
+    bool lvgl_port_is_suspended(void);
+
+#if LVGL_PORT_TOUCH_INTERRUPT
+    /**
+     * @brief Notifies the touch task that the touch controller has new data, to be called from its INT interrupt.
+     *
+     * @param[in] tp: Touch panel handle
+     */
+    void lvgl_port_notify_touch_interrupt(esp_lcd_touch_handle_t tp);
+#endif
+
     /**
      * @brief Notifies the LVGL task when the transmission of the RGB frame buffer is completed.
      *
@@ -163,6 +366,30 @@ extern "C"
      */
     bool lvgl_port_notify_rgb_vsync(void);
 
+    /**
+     * @brief Get the rendering statistics of the recent frames
+     *
+     * @note Does not take the LVGL mutex, so it can be called from any task while the LVGL task keeps rendering.
+     *
+     * @param[out] stats: Statistics, all zero until the first frame is flushed
+     */
+    void lvgl_port_get_stats(lvgl_port_stats_t *stats);
+
+#if LVGL_PORT_ROTATION_SCANOUT
+    /**
+     * @brief Fill an RGB bounce buffer from the LVGL frame buffer currently being scanned out, rotated by 180 degrees.
+     *
+     * @param[out] bounce_buf: Bounce buffer to fill
+     * @param[in] pos_px: Screen position of the first pixel in the bounce buffer
+     * @param[in] len_bytes: Size of the bounce buffer, in bytes
+     *
+     * @return
+     *      - true:  The tasks need to be re-scheduled
+     *      - false: The tasks don't need to be re-scheduled
+     */
+    bool lvgl_port_fill_rgb_bounce_buffer(void *bounce_buf, int pos_px, int len_bytes);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
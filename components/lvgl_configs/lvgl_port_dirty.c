@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+
+#include "lvgl_port_dirty.h"
+
+void lvgl_port_dirty_set_full(lv_port_dirty_area_t *dirty_area, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    dirty_area->inv_p = 1;
+    lv_area_set(&dirty_area->inv_areas[0], 0, 0, hor_res - 1, ver_res - 1);
+}
+
+void lvgl_port_dirty_add(lv_port_dirty_area_t *dirty_area, const lv_area_t *area, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    if (dirty_area->inv_p >= LVGL_PORT_DIRTY_AREA_MAX)
+    {
+        lvgl_port_dirty_set_full(dirty_area, hor_res, ver_res);
+        return;
+    }
+    dirty_area->inv_areas[dirty_area->inv_p++] = *area;
+}
+
+void lvgl_port_dirty_coalesce(lv_port_dirty_area_t *dirty_area)
+{
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (int i = 0; i < dirty_area->inv_p; i++)
+        {
+            for (int j = i + 1; j < dirty_area->inv_p; j++)
+            {
+                lv_area_t bounds;
+                _lv_area_join(&bounds, &dirty_area->inv_areas[i], &dirty_area->inv_areas[j]);
+                if (lv_area_get_size(&bounds) <= lv_area_get_size(&dirty_area->inv_areas[i]) +
+                                                     lv_area_get_size(&dirty_area->inv_areas[j]) + LVGL_PORT_DIRTY_AREA_COST_PX)
+                {
+                    // Replace area `i` by the bounding box and drop area `j`
+                    dirty_area->inv_areas[i] = bounds;
+                    dirty_area->inv_areas[j] = dirty_area->inv_areas[--dirty_area->inv_p];
+                    merged = true;
+                    j = i; // Compare the grown area against all the others again
+                }
+            }
+        }
+    }
+}
+
+void lvgl_port_dirty_save(lv_port_dirty_area_t *dirty_area, const lv_disp_t *disp)
+{
+    dirty_area->inv_p = 0;
+    for (int i = 0; i < disp->inv_p; i++)
+    {
+        if (disp->inv_area_joined[i] == 0)
+        {
+            lvgl_port_dirty_add(dirty_area, &disp->inv_areas[i], disp->driver->hor_res, disp->driver->ver_res); // Save unjoined areas only
+        }
+    }
+    lvgl_port_dirty_coalesce(dirty_area);
+}
+
+void lvgl_port_dirty_merge(lv_port_dirty_area_t *dirty_area, const lv_port_dirty_area_t *other, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    for (int i = 0; i < other->inv_p; i++)
+    {
+        lvgl_port_dirty_add(dirty_area, &other->inv_areas[i], hor_res, ver_res);
+    }
+    lvgl_port_dirty_coalesce(dirty_area);
+}
+
+uint32_t lvgl_port_dirty_get_size(const lv_port_dirty_area_t *dirty_area)
+{
+    uint32_t size = 0;
+    for (int i = 0; i < dirty_area->inv_p; i++)
+    {
+        size += lv_area_get_size(&dirty_area->inv_areas[i]);
+    }
+    return size;
+}
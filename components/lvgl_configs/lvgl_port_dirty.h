@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "lvgl.h"
+#include "lvgl_port_rotate.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Maximum number of dirty areas tracked per frame buffer: one frame's unjoined areas plus the previous frame's
+#define LVGL_PORT_DIRTY_AREA_MAX (LV_INV_BUF_SIZE * 2)
+
+// Fixed cost of copying one area, expressed in pixels, used to decide whether to merge two areas
+#define LVGL_PORT_DIRTY_AREA_COST_PX (LVGL_PORT_ROTATE_TILE_SIZE * LVGL_PORT_ROTATE_TILE_SIZE)
+
+    // Structure to store information about dirty areas that need refreshing
+    typedef struct
+    {
+        uint16_t inv_p;                                // Number of dirty areas
+        lv_area_t inv_areas[LVGL_PORT_DIRTY_AREA_MAX]; // Array of dirty areas, none of them joined
+    } lv_port_dirty_area_t;
+
+    /**
+     * @brief Mark the whole hor_res x ver_res screen as dirty
+     */
+    void lvgl_port_dirty_set_full(lv_port_dirty_area_t *dirty_area, lv_coord_t hor_res, lv_coord_t ver_res);
+
+    /**
+     * @brief Add an area to the dirty areas, falling back to the whole hor_res x ver_res screen if there is no room left
+     */
+    void lvgl_port_dirty_add(lv_port_dirty_area_t *dirty_area, const lv_area_t *area, lv_coord_t hor_res, lv_coord_t ver_res);
+
+    /**
+     * @brief Merge dirty areas where copying the bounding box is cheaper than copying both areas
+     *
+     * @note Each copied area costs its pixels plus `LVGL_PORT_DIRTY_AREA_COST_PX`, so overlapping or adjacent areas
+     *       are always merged while distant ones are kept apart.
+     *
+     */
+    void lvgl_port_dirty_coalesce(lv_port_dirty_area_t *dirty_area);
+
+    /**
+     * @brief Replace the dirty areas by the unjoined invalid areas of the frame `disp` is refreshing, coalesced
+     */
+    void lvgl_port_dirty_save(lv_port_dirty_area_t *dirty_area, const lv_disp_t *disp);
+
+    /**
+     * @brief Add the areas of `other` to the dirty areas and coalesce them
+     *
+     * A frame buffer last shown `n` frames ago is brought up to date by copying the union of the last `n` frames'
+     * areas, built with this function.
+     */
+    void lvgl_port_dirty_merge(lv_port_dirty_area_t *dirty_area, const lv_port_dirty_area_t *other, lv_coord_t hor_res, lv_coord_t ver_res);
+
+    /**
+     * @brief Get the number of pixels copying the dirty areas moves, counting any overlap once per area
+     */
+    uint32_t lvgl_port_dirty_get_size(const lv_port_dirty_area_t *dirty_area);
+
+#ifdef __cplusplus
+}
+#endif
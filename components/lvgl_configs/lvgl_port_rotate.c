@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+
+#include "esp_attr.h"
+#include "lvgl_port_rotate.h"
+
+#define ROTATE_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// Swap the two RGB565 pixels of a 32-bit word
+#define ROTATE_SWAP_PIXELS(p) (((p) >> 16) | ((p) << 16))
+
+IRAM_ATTR void lvgl_port_rotate_copy(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
+{
+#if LVGL_PORT_ROTATE_BLOCKED
+    switch (rotation)
+    {
+    case 90:
+    case 270:
+        lvgl_port_rotate_copy_tiled(from, to, x_start, y_start, x_end, y_end, w, h, rotation);
+        break;
+    case 180:
+        lvgl_port_rotate_copy_180(from, to, x_start, y_start, x_end, y_end, w, h);
+        break;
+    default:
+        break; // Do nothing for unsupported rotation angles
+    }
+#else
+    lvgl_port_rotate_copy_reference(from, to, x_start, y_start, x_end, y_end, w, h, rotation);
+#endif /* LVGL_PORT_ROTATE_BLOCKED */
+}
+
+IRAM_ATTR void lvgl_port_rotate_copy_reference(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
+{
+    int from_index = 0;     // Index for source buffer
+    int to_index = 0;       // Index for destination buffer
+    int to_index_const = 0; // Constant index for destination buffer
+
+    switch (rotation)
+    {
+    case 90:
+        to_index_const = (w - x_start - 1) * h; // Calculate constant index for 90-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++)
+        {
+            from_index = from_y * w + x_start;  // Calculate index in the source buffer
+            to_index = to_index_const + from_y; // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++)
+            {
+                *(to + to_index) = *(from + from_index); // Copy pixel
+                from_index += 1;                         // Move to the next pixel in the source
+                to_index -= h;                           // Move to the next pixel in the destination
+            }
+        }
+        break;
+    case 180:
+        to_index_const = h * w - x_start - 1; // Calculate constant index for 180-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++)
+        {
+            from_index = from_y * w + x_start;      // Calculate index in the source buffer
+            to_index = to_index_const - from_y * w; // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++)
+            {
+                *(to + to_index) = *(from + from_index); // Copy pixel
+                from_index += 1;                         // Move to the next pixel in the source
+                to_index -= 1;                           // Move to the next pixel in the destination
+            }
+        }
+        break;
+    case 270:
+        to_index_const = (x_start + 1) * h - 1; // Calculate constant index for 270-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++)
+        {
+            from_index = from_y * w + x_start;  // Calculate index in the source buffer
+            to_index = to_index_const - from_y; // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++)
+            {
+                *(to + to_index) = *(from + from_index); // Copy pixel
+                from_index += 1;                         // Move to the next pixel in the source
+                to_index += h;                           // Move to the next pixel in the destination
+            }
+        }
+        break;
+    default:
+        break; // Do nothing for unsupported rotation angles
+    }
+}
+
+// Rotate a dirty area by 90/270 degrees one tile at a time, so both the source rows and the destination
+// columns of a tile stay within a handful of PSRAM cache lines
+IRAM_ATTR void lvgl_port_rotate_copy_tiled(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
+{
+    for (int tile_y = y_start; tile_y <= y_end; tile_y += LVGL_PORT_ROTATE_TILE_SIZE)
+    {
+        const int tile_y_end = ROTATE_MIN(tile_y + LVGL_PORT_ROTATE_TILE_SIZE - 1, y_end); // Last row of the tile
+        for (int tile_x = x_start; tile_x <= x_end; tile_x += LVGL_PORT_ROTATE_TILE_SIZE)
+        {
+            const int tile_x_end = ROTATE_MIN(tile_x + LVGL_PORT_ROTATE_TILE_SIZE - 1, x_end); // Last column of the tile
+
+            // Walk the tile column by column so every destination run is contiguous
+            for (int from_x = tile_x; from_x <= tile_x_end; from_x++)
+            {
+                const uint16_t *src = from + tile_y * w + from_x; // First source pixel of the column
+                uint16_t *dst;                                    // First destination pixel of the run
+                int dst_step;                                     // Destination step per source row
+                if (rotation == 90)
+                {
+                    dst = to + (w - from_x - 1) * h + tile_y;
+                    dst_step = 1;
+                }
+                else
+                {
+                    dst = to + from_x * h + (h - tile_y - 1);
+                    dst_step = -1;
+                }
+                for (int from_y = tile_y; from_y <= tile_y_end; from_y++)
+                {
+                    *dst = *src;     // Copy pixel
+                    src += w;        // Move to the next row in the source
+                    dst += dst_step; // Move to the next pixel in the destination
+                }
+            }
+        }
+    }
+}
+
+// Rotate a dirty area by 180 degrees: every source row lands reversed in the mirrored destination row
+IRAM_ATTR void lvgl_port_rotate_copy_180(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h)
+{
+    for (int from_y = y_start; from_y <= y_end; from_y++)
+    {
+        lvgl_port_rotate_reverse(from + from_y * w + x_start, to + (h - from_y - 1) * w + (w - 1 - x_end), x_end - x_start + 1);
+    }
+}
+
+IRAM_ATTR void lvgl_port_rotate_reverse(const uint16_t *src, uint16_t *dst, int len)
+{
+    uint16_t *dst_end = dst + len; // The destination is written backwards from its end
+
+    // Copy a leading pixel so the source is word aligned
+    if (((uintptr_t)src & 2) && len > 0)
+    {
+        *--dst_end = *src++;
+        len--;
+    }
+
+    // Source pixels (i, i + 1) land at destination (len - 2 - i, len - 1 - i): one word with its halves swapped,
+    // as long as the destination end is word aligned as well
+    if (((uintptr_t)dst_end & 2) == 0)
+    {
+        const uint32_t *src_word = (const uint32_t *)src;
+        uint32_t *dst_word = (uint32_t *)dst_end;
+        for (; len >= 4; len -= 4)
+        {
+            const uint32_t p0 = src_word[0];
+            const uint32_t p1 = src_word[1];
+            dst_word[-1] = ROTATE_SWAP_PIXELS(p0);
+            dst_word[-2] = ROTATE_SWAP_PIXELS(p1);
+            src_word += 2;
+            dst_word -= 2;
+        }
+        if (len >= 2)
+        {
+            const uint32_t p0 = *src_word++;
+            *--dst_word = ROTATE_SWAP_PIXELS(p0);
+            len -= 2;
+        }
+        src = (const uint16_t *)src_word;
+        dst_end = (uint16_t *)dst_word;
+    }
+
+    // Copy the trailing pixel, or everything if the alignments don't match
+    while (len-- > 0)
+    {
+        *--dst_end = *src++;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Set the pixel copy kernel used for rotation:
+ *      - 0: Reference per-pixel copy
+ *      - 1: Tiled 90/270 degree transpose and word-wide 180 degree row reversal
+ *
+ */
+#ifdef CONFIG_EXAMPLE_LVGL_PORT_ROTATE_BLOCKED
+#define LVGL_PORT_ROTATE_BLOCKED (1)
+#else
+#define LVGL_PORT_ROTATE_BLOCKED (0)
+#endif
+#define LVGL_PORT_ROTATE_TILE_SIZE (16) // Tile edge in pixels, 16 RGB565 pixels fill half a 64-byte PSRAM cache line
+
+    /**
+     * @brief Copy the area (x_start, y_start)-(x_end, y_end) of a w x h RGB565 frame into another frame, rotated
+     *
+     * The kernel is chosen by `LVGL_PORT_ROTATE_BLOCKED`. Pixels outside the area are not written.
+     *
+     * @param from Source frame, w pixels per row
+     * @param to Destination frame, w pixels per row for 180 degrees, h pixels per row for 90 and 270 degrees
+     * @param x_start, y_start, x_end, y_end Area to copy, inclusive, in source coordinates
+     * @param w, h Size of the source frame
+     * @param rotation Rotation in degrees, 90, 180 or 270, anything else copies nothing
+     */
+    void lvgl_port_rotate_copy(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation);
+
+    /**
+     * @brief Reference per-pixel kernel of `lvgl_port_rotate_copy()`, for all rotations
+     */
+    void lvgl_port_rotate_copy_reference(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation);
+
+    /**
+     * @brief Tiled kernel of `lvgl_port_rotate_copy()`, for 90 and 270 degrees
+     */
+    void lvgl_port_rotate_copy_tiled(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation);
+
+    /**
+     * @brief Word-wide kernel of `lvgl_port_rotate_copy()`, for 180 degrees
+     */
+    void lvgl_port_rotate_copy_180(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h);
+
+    /**
+     * @brief Copy `len` pixels from `src` to `dst` in reverse order, `dst[i] = src[len - 1 - i]`
+     *
+     * Two pixels are moved per 32-bit access wherever the alignment of the buffers allows it. Safe to call from
+     * an ISR.
+     */
+    void lvgl_port_rotate_reverse(const uint16_t *src, uint16_t *dst, int len);
+
+#ifdef __cplusplus
+}
+#endif
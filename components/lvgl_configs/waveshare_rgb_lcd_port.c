@@ -12,6 +12,14 @@ IRAM_ATTR static bool rgb_lcd_on_vsync_event(esp_lcd_panel_handle_t panel, const
     return lvgl_port_notify_rgb_vsync();
 }
 
+#if LVGL_PORT_ROTATION_SCANOUT
+// Bounce buffer empty callback function
+IRAM_ATTR static bool rgb_lcd_on_bounce_empty(esp_lcd_panel_handle_t panel, void *bounce_buf, int pos_px, int len_bytes, void *user_ctx)
+{
+    return lvgl_port_fill_rgb_bounce_buffer(bounce_buf, pos_px, len_bytes);
+}
+#endif
+
 #if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
 /**
  * @brief I2C master initialization
@@ -102,7 +110,11 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
         },
         .data_width = EXAMPLE_RGB_DATA_WIDTH,                    // Data width for RGB
         .bits_per_pixel = EXAMPLE_RGB_BIT_PER_PIXEL,             // Bits per pixel
+#if LVGL_PORT_ROTATION_SCANOUT
+        .num_fbs = 0,                                            // Frame buffers are owned by the LVGL port
+#else
         .num_fbs = LVGL_PORT_LCD_RGB_BUFFER_NUMS,                // Number of frame buffers
+#endif
         .bounce_buffer_size_px = EXAMPLE_RGB_BOUNCE_BUFFER_SIZE, // Bounce buffer size in pixels
         .sram_trans_align = 4,                                   // SRAM transaction alignment
         .psram_trans_align = 64,                                 // PSRAM transaction alignment
@@ -131,6 +143,9 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
         },
         .flags = {
             .fb_in_psram = 1, // Use PSRAM for framebuffer
+#if LVGL_PORT_ROTATION_SCANOUT
+            .no_fb = 1, // Bounce buffers are filled by `rgb_lcd_on_bounce_empty`
+#endif
         },
     };
 
@@ -170,7 +185,15 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
             .mirror_x = 0, // No mirroring of X
             .mirror_y = 0, // No mirroring of Y
         },
+#if LVGL_PORT_TOUCH_INTERRUPT
+        .interrupt_callback = lvgl_port_notify_touch_interrupt, // Wake the touch task when new data is ready
+#endif
     };
+#if LVGL_PORT_TOUCH_INTERRUPT
+    // The GT911 driver registers its INT handler through the shared GPIO ISR service
+    esp_err_t isr_ret = gpio_install_isr_service(0);
+    ESP_ERROR_CHECK(isr_ret == ESP_ERR_INVALID_STATE ? ESP_OK : isr_ret); // Already installed is fine
+#endif
     ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle)); // Create new I2C GT911 touch controller
 #endif                                                                               // CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
 
@@ -182,6 +205,9 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
         .on_bounce_frame_finish = rgb_lcd_on_vsync_event, // Callback for bounce frame finish
 #else
         .on_vsync = rgb_lcd_on_vsync_event, // Callback for vertical sync
+#endif
+#if LVGL_PORT_ROTATION_SCANOUT
+        .on_bounce_empty = rgb_lcd_on_bounce_empty, // Callback for bounce buffer refill
 #endif
     };
     ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL)); // Register event callbacks
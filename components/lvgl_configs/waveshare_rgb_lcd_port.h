@@ -67,7 +67,11 @@
 #define EXAMPLE_LCD_BK_LIGHT_OFF_LEVEL !EXAMPLE_LCD_BK_LIGHT_ON_LEVEL
 
 #define EXAMPLE_PIN_NUM_TOUCH_RST (-1) // -1 if not used
+#if LVGL_PORT_TOUCH_INTERRUPT
+#define EXAMPLE_PIN_NUM_TOUCH_INT (GPIO_INPUT_IO_4) // -1 if not used
+#else
 #define EXAMPLE_PIN_NUM_TOUCH_INT (-1) // -1 if not used
+#endif
 
 static const char *TAG = "example";
 
@@ -0,0 +1,318 @@
+#include <string.h>
+
+#include "esp_timer.h"
+
+#include "digit_atlas.h"
+
+#define DIGIT_ATLAS_FIRST (0x20)                                    // Letters in the atlas, printable ASCII
+#define DIGIT_ATLAS_LAST (0x7e)
+#define DIGIT_ATLAS_LETTERS (DIGIT_ATLAS_LAST - DIGIT_ATLAS_FIRST + 1)
+#define DIGIT_ATLAS_NONE (UINT32_MAX)                               // Offset of the letters the font doesn't have
+
+// Glyph cells of a font, each as wide as the glyph advance and as high as the line, over the background
+typedef struct {
+    const lv_font_t *font;
+    lv_color_t color;       // Text colour
+    lv_color_t bg;          // Background colour the glyphs are blended over
+    uint32_t used;          // Blit count at the last use, the least recently used atlas is replaced
+    uint32_t size;
+    lv_color_t *cells;
+    uint32_t offset[DIGIT_ATLAS_LETTERS];  // First pixel of the cell of each letter in `cells`
+    uint8_t width[DIGIT_ATLAS_LETTERS];
+} digit_atlas_t;
+
+typedef struct {
+    int64_t draw_start;
+    const lv_font_t *rejected;  // Font found unfit for an atlas, the label is drawn by lv_label while it has it
+} digit_atlas_label_t;
+
+static digit_atlas_stats_t digit_atlas_stats = { .enabled = DIGIT_ATLAS_ENABLED };
+static digit_atlas_t digit_atlas_cache[DIGIT_ATLAS_CACHE_SIZE];
+static uint32_t digit_atlas_blits;
+
+// Whether every glyph of the font fits in its cell, so cells can be copied side by side, and the font has
+// few enough of them. Fills in the cell widths and returns the number of pixels of the cells.
+static uint32_t digit_atlas_measure(const lv_font_t *font, uint8_t *width) {
+    if (font->subpx != LV_FONT_SUBPX_NONE) {
+        return 0;
+    }
+    // Kerning would move the glyphs depending on their neighbours
+    if (font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt ||
+        ((const lv_font_fmt_txt_dsc_t *)font->dsc)->kern_dsc != NULL) {
+        return 0;
+    }
+
+    uint32_t glyphs = 0;
+    uint32_t pixels = 0;
+    for (uint32_t letter = DIGIT_ATLAS_FIRST; letter <= DIGIT_ATLAS_LAST; letter++) {
+        lv_font_glyph_dsc_t g;
+        width[letter - DIGIT_ATLAS_FIRST] = 0;
+        if (!lv_font_get_glyph_dsc(font, &g, letter, '\0')) {
+            continue;
+        }
+        int32_t top = font->line_height - font->base_line - g.box_h - g.ofs_y;
+        if (g.bpp != 8 || g.adv_w == 0 || g.adv_w > UINT8_MAX || g.ofs_x < 0 || g.ofs_x + g.box_w > g.adv_w ||
+            top < 0 || top + g.box_h > font->line_height || ++glyphs > DIGIT_ATLAS_GLYPHS_MAX) {
+            return 0;
+        }
+        width[letter - DIGIT_ATLAS_FIRST] = g.adv_w;
+        pixels += g.adv_w * font->line_height;
+    }
+    return pixels;
+}
+
+// Blends each glyph over the background the way the software renderer does for an opaque label
+static void digit_atlas_render(digit_atlas_t *atlas) {
+    const lv_font_t *font = atlas->font;
+    lv_color_t *cell = atlas->cells;
+
+    for (uint32_t letter = DIGIT_ATLAS_FIRST; letter <= DIGIT_ATLAS_LAST; letter++) {
+        uint32_t w = atlas->width[letter - DIGIT_ATLAS_FIRST];
+        if (w == 0) {
+            atlas->offset[letter - DIGIT_ATLAS_FIRST] = DIGIT_ATLAS_NONE;
+            continue;
+        }
+        atlas->offset[letter - DIGIT_ATLAS_FIRST] = cell - atlas->cells;
+
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(font, &g, letter, '\0');
+        const uint8_t *bitmap = g.box_w > 0 && g.box_h > 0 ? lv_font_get_glyph_bitmap(font, letter) : NULL;
+        int32_t top = font->line_height - font->base_line - g.box_h - g.ofs_y;
+        for (int32_t y = 0; y < font->line_height; y++) {
+            for (int32_t x = 0; x < (int32_t)w; x++, cell++) {
+                lv_opa_t a = LV_OPA_TRANSP;
+                if (bitmap && x >= g.ofs_x && x < g.ofs_x + g.box_w && y >= top && y < top + g.box_h) {
+                    a = bitmap[(y - top) * g.box_w + x - g.ofs_x];
+                }
+                *cell = a >= LV_OPA_MAX ? atlas->color : a <= LV_OPA_MIN ? atlas->bg : lv_color_mix(atlas->color, atlas->bg, a);
+            }
+        }
+    }
+}
+
+static void digit_atlas_free(digit_atlas_t *atlas) {
+    if (atlas->cells) {
+        digit_atlas_stats.atlases--;
+        digit_atlas_stats.bytes -= atlas->size;
+        lv_mem_free(atlas->cells);
+    }
+    lv_memset_00(atlas, sizeof(digit_atlas_t));
+}
+
+// Returns the cached atlas or renders it in place of the least recently used one, NULL if the font is unfit
+static digit_atlas_t *digit_atlas_get(const lv_font_t *font, lv_color_t color, lv_color_t bg) {
+    digit_atlas_t *lru = &digit_atlas_cache[0];
+    for (uint32_t i = 0; i < DIGIT_ATLAS_CACHE_SIZE; i++) {
+        digit_atlas_t *atlas = &digit_atlas_cache[i];
+        if (atlas->cells && atlas->font == font && atlas->color.full == color.full && atlas->bg.full == bg.full) {
+            atlas->used = digit_atlas_blits;
+            return atlas;
+        }
+        if (!atlas->cells || (lru->cells && atlas->used < lru->used)) {
+            lru = atlas;
+        }
+    }
+
+    uint8_t width[DIGIT_ATLAS_LETTERS];
+    uint32_t pixels = digit_atlas_measure(font, width);
+    if (pixels == 0) {
+        return NULL;
+    }
+    digit_atlas_free(lru);
+    uint32_t size = pixels * sizeof(lv_color_t);
+    lv_color_t *cells = lv_mem_alloc(size);
+    if (!cells) {
+        LV_LOG_WARN("no memory for a %" LV_PRIu32 " byte digit atlas", size);
+        return NULL;
+    }
+    lru->font = font;
+    lru->color = color;
+    lru->bg = bg;
+    lru->used = digit_atlas_blits;
+    lru->size = size;
+    lru->cells = cells;
+    memcpy(lru->width, width, sizeof(width));
+    digit_atlas_render(lru);
+
+    digit_atlas_stats.atlases++;
+    digit_atlas_stats.bytes += size;
+    return lru;
+}
+
+// The colour behind `area` of the label if it's a single opaque colour: the background of the first opaque
+// ancestor, with only transparent ancestors in between and no sibling drawn before reaching under the area.
+// What an ancestor draws besides its background (an arc's ring) isn't looked at and must stay clear of it.
+static bool digit_atlas_bg_color(lv_obj_t *obj, const lv_area_t *area, lv_color_t *bg) {
+    for (lv_obj_t *parent = lv_obj_get_parent(obj); parent; obj = parent, parent = lv_obj_get_parent(parent)) {
+        uint32_t index = lv_obj_get_index(obj);
+        for (uint32_t i = 0; i < index; i++) {
+            lv_obj_t *sibling = lv_obj_get_child(parent, i);
+            lv_area_t sibling_area;
+            lv_coord_t ext = _lv_obj_get_ext_draw_size(sibling);
+            lv_obj_get_coords(sibling, &sibling_area);
+            lv_area_increase(&sibling_area, ext, ext);
+            if (!lv_obj_has_flag(sibling, LV_OBJ_FLAG_HIDDEN) && _lv_area_is_on(&sibling_area, area)) {
+                return false;
+            }
+        }
+
+        lv_opa_t opa = lv_obj_get_style_bg_opa(parent, LV_PART_MAIN);
+        if (opa > LV_OPA_MIN && (opa < LV_OPA_MAX || lv_obj_get_style_bg_grad_dir(parent, LV_PART_MAIN) != LV_GRAD_DIR_NONE)) {
+            return false;
+        }
+        if (lv_obj_get_style_bg_img_src(parent, LV_PART_MAIN) != NULL) {
+            return false;
+        }
+        if (opa >= LV_OPA_MAX) {
+            *bg = lv_obj_get_style_bg_color_filtered(parent, LV_PART_MAIN);
+            return true;
+        }
+    }
+    return false; // Over the display background
+}
+
+// Whether lv_obj would draw nothing of the label but its text, and lv_label would draw it opaque on one line
+static bool digit_atlas_plain(lv_obj_t *obj) {
+    if (lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) > LV_OPA_MIN || lv_obj_get_style_bg_img_src(obj, LV_PART_MAIN) ||
+        lv_obj_get_style_border_width(obj, LV_PART_MAIN) > 0 || lv_obj_get_style_shadow_width(obj, LV_PART_MAIN) > 0) {
+        return false;
+    }
+    if (lv_obj_get_style_text_opa(obj, LV_PART_MAIN) < LV_OPA_MAX ||
+        lv_obj_get_style_text_decor(obj, LV_PART_MAIN) != LV_TEXT_DECOR_NONE ||
+        lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) != LV_BLEND_MODE_NORMAL) {
+        return false;
+    }
+    // Also covers the static widgets a static layer hides with a zero opacity
+    for (lv_obj_t *parent = obj; parent; parent = lv_obj_get_parent(parent)) {
+        if (lv_obj_get_style_opa(parent, LV_PART_MAIN) < LV_OPA_MAX) {
+            return false;
+        }
+    }
+    lv_label_long_mode_t mode = lv_label_get_long_mode(obj);
+    return !lv_label_get_recolor(obj) && mode != LV_LABEL_LONG_SCROLL && mode != LV_LABEL_LONG_SCROLL_CIRCULAR &&
+           lv_obj_get_scroll_top(obj) == 0;
+}
+
+// Draws the label from an atlas, returns false to leave it to lv_label
+static bool digit_atlas_draw(lv_obj_t *obj, digit_atlas_label_t *label, lv_draw_ctx_t *draw_ctx) {
+    // Only straight into the RGB frame buffer, not into snapshots or the layers of transformed objects
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (!disp || disp->driver->screen_transp || draw_ctx->buf != disp->driver->draw_buf->buf_act) {
+        return false;
+    }
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    const char *text = lv_label_get_text(obj);
+    if (!text || font == label->rejected || !digit_atlas_plain(obj)) {
+        return false;
+    }
+
+    lv_area_t coords;
+    lv_obj_get_content_coords(obj, &coords);
+    lv_color_t bg;
+    if (!digit_atlas_bg_color(obj, &coords, &bg)) {
+        return false;
+    }
+    digit_atlas_t *atlas = digit_atlas_get(font, lv_obj_get_style_text_color_filtered(obj, LV_PART_MAIN), bg);
+    if (!atlas) {
+        label->rejected = font;
+        return false;
+    }
+
+    // The width as lv_txt_get_width() measures it, a letter outside the atlas leaves the text to lv_label
+    lv_coord_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+    int32_t line_w = 0;
+    for (const char *c = text; *c; c++) {
+        uint32_t letter = (uint8_t)*c;
+        if (letter < DIGIT_ATLAS_FIRST || letter > DIGIT_ATLAS_LAST ||
+            atlas->offset[letter - DIGIT_ATLAS_FIRST] == DIGIT_ATLAS_NONE) {
+            return false;
+        }
+        line_w += atlas->width[letter - DIGIT_ATLAS_FIRST] + letter_space;
+    }
+    line_w -= *text ? letter_space : 0;
+    if (line_w > lv_area_get_width(&coords)) {
+        return false; // Wrapped or clipped by lv_label
+    }
+
+    atlas->used = ++digit_atlas_blits;
+    lv_area_t clip;
+    if (!_lv_area_intersect(&clip, &coords, draw_ctx->clip_area)) {
+        return true;
+    }
+    int32_t x = coords.x1;
+    switch (lv_obj_calculate_style_text_align(obj, LV_PART_MAIN, text)) {
+    case LV_TEXT_ALIGN_CENTER:
+        x += (lv_area_get_width(&coords) - line_w) / 2;
+        break;
+    case LV_TEXT_ALIGN_RIGHT:
+        x += lv_area_get_width(&coords) - line_w;
+        break;
+    default:
+        break;
+    }
+
+    lv_color_t *buf = draw_ctx->buf;
+    int32_t buf_w = lv_area_get_width(draw_ctx->buf_area);
+    int32_t y1 = LV_MAX(coords.y1, clip.y1);
+    int32_t y2 = LV_MIN(coords.y1 + font->line_height - 1, clip.y2);
+    for (const char *c = text; *c; c++) {
+        uint32_t letter = (uint8_t)*c - DIGIT_ATLAS_FIRST;
+        int32_t w = atlas->width[letter];
+        int32_t x1 = LV_MAX(x, clip.x1);
+        int32_t x2 = LV_MIN(x + w - 1, clip.x2);
+        const lv_color_t *cell = atlas->cells + atlas->offset[letter];
+        for (int32_t y = y1; x1 <= x2 && y <= y2; y++) {
+            memcpy(buf + (y - draw_ctx->buf_area->y1) * buf_w + x1 - draw_ctx->buf_area->x1,
+                   cell + (y - coords.y1) * w + x1 - x, (x2 - x1 + 1) * sizeof(lv_color_t));
+        }
+        x += w + letter_space;
+    }
+    return true;
+}
+
+static void digit_atlas_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    digit_atlas_label_t *label = lv_event_get_user_data(e);
+
+    switch (code) {
+    case LV_EVENT_DRAW_MAIN_BEGIN:
+        label->draw_start = esp_timer_get_time();
+        break;
+    case LV_EVENT_DRAW_MAIN_END:
+        digit_atlas_stats.draws++;
+        digit_atlas_stats.draw_us += esp_timer_get_time() - label->draw_start;
+        break;
+    case LV_EVENT_DELETE:
+        lv_mem_free(label);
+        break;
+    default:
+        break;
+    }
+}
+
+// Registered to run before lv_label, which then doesn't draw the label at all
+static void digit_atlas_draw_cb(lv_event_t *e) {
+    if (digit_atlas_draw(lv_event_get_target(e), lv_event_get_user_data(e), lv_event_get_draw_ctx(e))) {
+        lv_event_stop_processing(e);
+    } else {
+        digit_atlas_stats.fallbacks++;
+    }
+}
+
+void digit_atlas_attach(lv_obj_t *label) {
+    digit_atlas_label_t *atlas_label = lv_mem_alloc(sizeof(digit_atlas_label_t));
+    LV_ASSERT_MALLOC(atlas_label);
+    if (!atlas_label) {
+        return;
+    }
+    lv_memset_00(atlas_label, sizeof(digit_atlas_label_t));
+    lv_obj_add_event_cb(label, digit_atlas_event_cb, LV_EVENT_ALL, atlas_label);
+    if (DIGIT_ATLAS_ENABLED) {
+        lv_obj_add_event_cb(label, digit_atlas_draw_cb, LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS, atlas_label);
+    }
+}
+
+void digit_atlas_get_stats(digit_atlas_stats_t *stats) {
+    // Written by the LVGL task, the fields may be a draw apart
+    *stats = digit_atlas_stats;
+}
@@ -0,0 +1,45 @@
+#ifndef EEZ_LVGL_UI_DIGIT_ATLAS_H
+#define EEZ_LVGL_UI_DIGIT_ATLAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <lvgl.h>
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Labels in a fixed-symbol font (e.g. ui_font_roboto_med_48, "0123456789.%-") are drawn from an atlas of glyph
+// cells pre-blended over the colour behind the label, so a new number is a few row copies instead of a glyph
+// lookup and an alpha blend per pixel. Labels that aren't over a single opaque colour are drawn by lv_label.
+#ifdef CONFIG_UI_DIGIT_ATLAS
+#define DIGIT_ATLAS_ENABLED (1)
+#else
+#define DIGIT_ATLAS_ENABLED (0)
+#endif
+
+#define DIGIT_ATLAS_GLYPHS_MAX (32) // Fonts with more ASCII glyphs (alphabets) are left to lv_label
+#define DIGIT_ATLAS_CACHE_SIZE (4)  // Atlases kept, one per font, text colour and background colour
+
+// Draw time of the atlas labels, to compare the atlas with lv_label
+typedef struct {
+    bool enabled;           // Whether the labels are drawn from atlases or by lv_label
+    uint32_t draws;         // Label draws since start-up, one per invalidated area a label is in
+    uint32_t draw_us;       // Total time spent drawing the labels
+    uint32_t fallbacks;     // Draws left to lv_label, e.g. over a translucent background
+    uint32_t atlases;       // Atlases in the cache
+    uint32_t bytes;         // Memory held by the atlases
+} digit_atlas_stats_t;
+
+// Draws an lv_label from an atlas whenever it can, call once after creating it
+void digit_atlas_attach(lv_obj_t *label);
+void digit_atlas_get_stats(digit_atlas_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*EEZ_LVGL_UI_DIGIT_ATLAS_H*/
@@ -9,6 +9,7 @@
  * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "eez-flow.h"
+#include "vars.h"
 #if EEZ_FOR_LVGL_LZ4_OPTION
 #include "eez-flow-lz4.h"
 #endif
@@ -45,21 +46,98 @@ void executeActionFunction(int actionId) {
 #include <math.h>
 #include <assert.h>
 #include <string.h>
+#if defined(EEZ_FOR_LVGL) && LVGL_VERSION_MAJOR < 9 && LV_MEM_CUSTOM && defined(__has_include)
+#if __has_include("esp_heap_caps.h")
+#include "esp_heap_caps.h"
+#define EEZ_FOR_LVGL_HEAP_CAPS 1
+#endif
+#endif
 namespace eez {
 #if defined(EEZ_FOR_LVGL)
+#ifndef EEZ_FOR_LVGL_SLAB_ARENA_SIZE
+#define EEZ_FOR_LVGL_SLAB_ARENA_SIZE (16 * 1024)
+#endif
+// Blocks of up to 256 bytes come from per size class free lists, carved page by page out of a static arena
+// (internal SRAM on the ESP32) and never returned to it. Larger blocks, and all blocks once the arena is used
+// up, come from the LVGL heap. Like the rest of eez-flow it's only called from the LVGL task.
+static const size_t SLAB_PAGE_SIZE = 512;
+static const size_t SLAB_PAGES = EEZ_FOR_LVGL_SLAB_ARENA_SIZE / SLAB_PAGE_SIZE;
+static const size_t SLAB_MIN_BLOCK_SIZE = 16;
+struct SlabBlock {
+	SlabBlock *next;
+};
+alignas(16) static uint8_t g_slabArena[SLAB_PAGES > 0 ? SLAB_PAGES * SLAB_PAGE_SIZE : 1];
+static uint8_t g_slabPageClass[SLAB_PAGES > 0 ? SLAB_PAGES : 1];
+static size_t g_slabPagesCarved;
+static SlabBlock *g_slabFree[EEZ_ALLOC_SIZE_CLASSES];
+static eez_alloc_stats_t g_allocStats;
 void initAllocHeap(uint8_t *heap, size_t heapSize) {
     EEZ_UNUSED(heap);
     EEZ_UNUSED(heapSize);
 }
+static SlabBlock *slabCarvePage(int sizeClass) {
+    if (g_slabPagesCarved == SLAB_PAGES) {
+        return nullptr;
+    }
+    uint8_t *page = g_slabArena + g_slabPagesCarved * SLAB_PAGE_SIZE;
+    g_slabPageClass[g_slabPagesCarved++] = sizeClass;
+    size_t blockSize = SLAB_MIN_BLOCK_SIZE << sizeClass;
+    SlabBlock *first = nullptr;
+    for (size_t offset = SLAB_PAGE_SIZE; offset >= blockSize; offset -= blockSize) {
+        auto block = (SlabBlock *)(page + offset - blockSize);
+        block->next = first;
+        first = block;
+    }
+    g_allocStats.classes[sizeClass].blocks += SLAB_PAGE_SIZE / blockSize;
+    g_allocStats.arena_used += SLAB_PAGE_SIZE;
+    return first;
+}
 void *alloc(size_t size, uint32_t id) {
     EEZ_UNUSED(id);
+    g_allocStats.allocs++;
+    g_allocStats.alloc_bytes += size;
+    for (int sizeClass = 0; size > 0 && sizeClass < EEZ_ALLOC_SIZE_CLASSES; sizeClass++) {
+        if (size <= SLAB_MIN_BLOCK_SIZE << sizeClass) {
+            SlabBlock *block = g_slabFree[sizeClass];
+            if (!block) {
+                block = slabCarvePage(sizeClass);
+            }
+            if (!block) {
+                break;
+            }
+            g_slabFree[sizeClass] = block->next;
+            auto &stats = g_allocStats.classes[sizeClass];
+            if (++stats.used > stats.peak) {
+                stats.peak = stats.used;
+            }
+            return block;
+        }
+    }
 #if LVGL_VERSION_MAJOR >= 9
-    return lv_malloc(size);
+    void *ptr = lv_malloc(size);
 #else
-    return lv_mem_alloc(size);
+    void *ptr = lv_mem_alloc(size);
 #endif
+    if (ptr) {
+        g_allocStats.heap_blocks++;
+        g_allocStats.heap_allocs++;
+    }
+    return ptr;
 }
 void free(void *ptr) {
+    if (ptr == 0) {
+        return;
+    }
+    uintptr_t offset = (uintptr_t)ptr - (uintptr_t)g_slabArena;
+    if (offset < SLAB_PAGES * SLAB_PAGE_SIZE) {
+        int sizeClass = g_slabPageClass[offset / SLAB_PAGE_SIZE];
+        auto block = (SlabBlock *)ptr;
+        block->next = g_slabFree[sizeClass];
+        g_slabFree[sizeClass] = block;
+        g_allocStats.classes[sizeClass].used--;
+        return;
+    }
+    g_allocStats.heap_blocks--;
 #if LVGL_VERSION_MAJOR >= 9
     lv_free(ptr);
 #else
@@ -68,17 +146,40 @@ void free(void *ptr) {
 }
 template<typename T> void freeObject(T *ptr) {
 	ptr->~T();
-#if LVGL_VERSION_MAJOR >= 9
-    lv_free(ptr);
+	free(ptr);
+}
+// Memory of the heap the blocks the slabs don't take go to. With LV_MEM_CUSTOM lv_mem_monitor() reports
+// nothing, those blocks come from the system heap, whose own use isn't the flow's.
+static void heapAllocInfo(uint32_t &free, uint32_t &alloc, uint32_t &largestFree) {
+#if EEZ_FOR_LVGL_HEAP_CAPS
+    free = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    alloc = 0;
+    largestFree = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
 #else
-	lv_mem_free(ptr);
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    free = mon.free_size;
+    alloc = mon.total_size - mon.free_size;
+    largestFree = mon.free_biggest_size;
 #endif
 }
 void getAllocInfo(uint32_t &free, uint32_t &alloc) {
-    lv_mem_monitor_t mon;
-    lv_mem_monitor(&mon);
-	free = mon.free_size;
-	alloc = mon.total_size - mon.free_size;
+    uint32_t largestFree;
+    heapAllocInfo(free, alloc, largestFree);
+    uint32_t slabUsed = 0;
+    for (int i = 0; i < EEZ_ALLOC_SIZE_CLASSES; i++) {
+        slabUsed += g_allocStats.classes[i].used * (SLAB_MIN_BLOCK_SIZE << i);
+    }
+    alloc += slabUsed;
+    // Unused blocks of the carved pages and the pages not carved yet
+    free += SLAB_PAGES * SLAB_PAGE_SIZE - slabUsed;
+}
+void getAllocInfo(uint32_t &free, uint32_t &alloc, uint32_t &largestFree, uint32_t &fragmentation) {
+    uint32_t heapFree;
+    uint32_t heapAlloc;
+    heapAllocInfo(heapFree, heapAlloc, largestFree);
+    getAllocInfo(free, alloc);
+    fragmentation = heapFree ? 100 - (uint32_t)((uint64_t)largestFree * 100 / heapFree) : 0;
 }
 #elif defined(EEZ_DASHBOARD_API)
 #include <emscripten/heap.h>
@@ -98,16 +199,39 @@ void getAllocInfo(uint32_t &free, uint32_t &alloc) {
 	free = emscripten_get_heap_max() - emscripten_get_heap_size();
 	alloc = emscripten_get_heap_size();
 }
+void getAllocInfo(uint32_t &free, uint32_t &alloc, uint32_t &largestFree, uint32_t &fragmentation) {
+	getAllocInfo(free, alloc);
+	largestFree = free;
+	fragmentation = 0;
+}
 #else
+#ifndef EEZ_ALLOC_POISON
+#define EEZ_ALLOC_POISON 0
+#endif
+// Blocks carry their size in a header and a footer (boundary tags), so free() finds and merges both neighbours
+// in O(1). Free blocks are kept in segregated lists, one per power of two of ALIGNMENT, linked through their
+// payload: alloc() scans the list of the requested size only, any block of a larger list fits.
 static const size_t ALIGNMENT = 64;
-static const size_t MIN_BLOCK_SIZE = 8;
-struct AllocBlock {
-	AllocBlock *next;
-	int free;
+static const size_t NUM_BINS = 16;
+struct alignas(8) AllocBlock {
 	size_t size;
+	uint32_t free;
 	uint32_t id;
 };
+struct alignas(8) AllocFooter {
+	size_t size;
+	uint32_t free;
+};
+struct FreeLinks {
+	AllocBlock *prev;
+	AllocBlock *next;
+};
+static const size_t MIN_BLOCK_SIZE = sizeof(FreeLinks);
 static uint8_t *g_heap;
+static uint8_t *g_heapEnd;
+static AllocBlock *g_bins[NUM_BINS];
+static size_t g_freeSize;
+static size_t g_allocSize;
 #if defined(EEZ_PLATFORM_STM32)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wparentheses"
@@ -116,12 +240,83 @@ EEZ_MUTEX_DECLARE(alloc);
 #if defined(EEZ_PLATFORM_STM32)
 #pragma GCC diagnostic pop
 #endif
+static inline AllocFooter *blockFooter(AllocBlock *block) {
+	return (AllocFooter *)((uint8_t *)(block + 1) + block->size);
+}
+static inline AllocBlock *nextBlock(AllocBlock *block) {
+	auto next = (AllocBlock *)(blockFooter(block) + 1);
+	return (uint8_t *)next < g_heapEnd ? next : nullptr;
+}
+static inline AllocBlock *prevBlock(AllocBlock *block) {
+	if ((uint8_t *)block == g_heap) {
+		return nullptr;
+	}
+	auto footer = (AllocFooter *)block - 1;
+	return (AllocBlock *)((uint8_t *)footer - footer->size) - 1;
+}
+static inline FreeLinks *freeLinks(AllocBlock *block) {
+	return (FreeLinks *)(block + 1);
+}
+static void setBlock(AllocBlock *block, size_t size, uint32_t free) {
+	block->size = size;
+	block->free = free;
+	auto footer = blockFooter(block);
+	footer->size = size;
+	footer->free = free;
+}
+static unsigned binIndex(size_t size) {
+	unsigned bin = 0;
+	for (size /= ALIGNMENT; size > 1 && bin < NUM_BINS - 1; size >>= 1) {
+		bin++;
+	}
+	return bin;
+}
+static void insertFreeBlock(AllocBlock *block) {
+	unsigned bin = binIndex(block->size);
+	auto links = freeLinks(block);
+	links->prev = nullptr;
+	links->next = g_bins[bin];
+	if (g_bins[bin]) {
+		freeLinks(g_bins[bin])->prev = block;
+	}
+	g_bins[bin] = block;
+	g_freeSize += block->size;
+}
+static void removeFreeBlock(AllocBlock *block) {
+	auto links = freeLinks(block);
+	if (links->prev) {
+		freeLinks(links->prev)->next = links->next;
+	} else {
+		g_bins[binIndex(block->size)] = links->next;
+	}
+	if (links->next) {
+		freeLinks(links->next)->prev = links->prev;
+	}
+	g_freeSize -= block->size;
+}
+static AllocBlock *findFreeBlock(size_t size) {
+	unsigned bin = binIndex(size);
+	for (AllocBlock *block = g_bins[bin]; block; block = freeLinks(block)->next) {
+		if (block->size >= size) {
+			return block;
+		}
+	}
+	for (bin++; bin < NUM_BINS; bin++) {
+		if (g_bins[bin]) {
+			return g_bins[bin];
+		}
+	}
+	return nullptr;
+}
 void initAllocHeap(uint8_t *heap, size_t heapSize) {
     g_heap = heap;
+	memset(g_bins, 0, sizeof(g_bins));
+	g_freeSize = 0;
+	g_allocSize = 0;
 	AllocBlock *first = (AllocBlock *)g_heap;
-	first->next = 0;
-	first->free = 1;
-	first->size = heapSize - sizeof(AllocBlock);
+	setBlock(first, (heapSize - sizeof(AllocBlock) - sizeof(AllocFooter)) & ~(sizeof(AllocFooter) - 1), 1);
+	g_heapEnd = (uint8_t *)(blockFooter(first) + 1);
+	insertFreeBlock(first);
 	EEZ_MUTEX_CREATE(alloc);
 }
 void *alloc(size_t size, uint32_t id) {
@@ -129,30 +324,24 @@ void *alloc(size_t size, uint32_t id) {
 		return nullptr;
 	}
 	if (EEZ_MUTEX_WAIT(alloc, osWaitForever)) {
-		AllocBlock *firstBlock = (AllocBlock *)g_heap;
-		AllocBlock *block = firstBlock;
 		size = ((size + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
-		while (block) {
-			if (block->free && block->size >= size) {
-				break;
-			}
-			block = block->next;
-		}
+		AllocBlock *block = findFreeBlock(size);
 		if (!block) {
 			EEZ_MUTEX_RELEASE(alloc);
 			return nullptr;
 		}
-		int remainingSize = block->size - size - sizeof(AllocBlock);
-		if (remainingSize >= (int)MIN_BLOCK_SIZE) {
-			auto newBlock = (AllocBlock *)((uint8_t *)block + sizeof(AllocBlock) + size);
-			newBlock->next = block->next;
-			newBlock->free = 1;
-			newBlock->size = remainingSize;
-			block->next = newBlock;
-			block->size = size;
+		removeFreeBlock(block);
+		size_t remainingSize = block->size - size;
+		if (remainingSize >= sizeof(AllocBlock) + sizeof(AllocFooter) + MIN_BLOCK_SIZE) {
+			setBlock(block, size, 0);
+			auto newBlock = (AllocBlock *)(blockFooter(block) + 1);
+			setBlock(newBlock, remainingSize - sizeof(AllocBlock) - sizeof(AllocFooter), 1);
+			insertFreeBlock(newBlock);
+		} else {
+			setBlock(block, block->size, 0);
 		}
-		block->free = 0;
 		block->id = id;
+		g_allocSize += block->size;
 		EEZ_MUTEX_RELEASE(alloc);
 		return block + 1;
 	}
@@ -163,35 +352,30 @@ void free(void *ptr) {
 		return;
 	}
 	if (EEZ_MUTEX_WAIT(alloc, osWaitForever)) {
-		AllocBlock *firstBlock = (AllocBlock *)g_heap;
-		AllocBlock *prevBlock = nullptr;
-		AllocBlock *block = firstBlock;
-		while (block && block + 1 < ptr) {
-			prevBlock = block;
-			block = block->next;
-		}
-		if (!block || block + 1 != ptr || block->free) {
+		AllocBlock *block = (AllocBlock *)ptr - 1;
+		if ((uint8_t *)block < g_heap || (uint8_t *)ptr >= g_heapEnd || block->free ||
+			blockFooter(block)->size != block->size || blockFooter(block)->free) {
 			assert(false);
 			EEZ_MUTEX_RELEASE(alloc);
 			return;
 		}
+		g_allocSize -= block->size;
+#if EEZ_ALLOC_POISON
 		memset(ptr, 0xCC, block->size);
-		auto nextBlock = block->next;
-		if (nextBlock && nextBlock->free) {
-			if (prevBlock && prevBlock->free) {
-				prevBlock->next = nextBlock->next;
-				prevBlock->size += sizeof(AllocBlock) + block->size + sizeof(AllocBlock) + nextBlock->size;
-			} else {
-				block->next = nextBlock->next;
-				block->size += sizeof(AllocBlock) + nextBlock->size;
-				block->free = 1;
-			}
-		} else if (prevBlock && prevBlock->free) {
-			prevBlock->next = nextBlock;
-			prevBlock->size += sizeof(AllocBlock) + block->size;
-		} else {
-			block->free = 1;
+#endif
+		auto prev = prevBlock(block);
+		if (prev && prev->free) {
+			removeFreeBlock(prev);
+			setBlock(prev, prev->size + sizeof(AllocFooter) + sizeof(AllocBlock) + block->size, 1);
+			block = prev;
+		}
+		auto next = nextBlock(block);
+		if (next && next->free) {
+			removeFreeBlock(next);
+			setBlock(block, block->size + sizeof(AllocFooter) + sizeof(AllocBlock) + next->size, 1);
 		}
+		setBlock(block, block->size, 1);
+		insertFreeBlock(block);
 		EEZ_MUTEX_RELEASE(alloc);
 	}
 }
@@ -211,7 +395,7 @@ void dumpAlloc(scpi_t *context) {
 			snprintf(buffer, sizeof(buffer), "ALOC (0x%08x): %d", (unsigned int)block->id, (int)block->size);
 		}
 		SCPI_ResultText(context, buffer);
-		block = block->next;
+		block = nextBlock(block);
 	}
 }
 #endif
@@ -219,16 +403,28 @@ void getAllocInfo(uint32_t &free, uint32_t &alloc) {
 	free = 0;
 	alloc = 0;
 	if (EEZ_MUTEX_WAIT(alloc, osWaitForever)) {
-		AllocBlock *first = (AllocBlock *)g_heap;
-		AllocBlock *block = first;
-		while (block) {
-			if (block->free) {
-				free += block->size;
-			} else {
-				alloc += block->size;
+		free = g_freeSize;
+		alloc = g_allocSize;
+		EEZ_MUTEX_RELEASE(alloc);
+	}
+}
+void getAllocInfo(uint32_t &free, uint32_t &alloc, uint32_t &largestFree, uint32_t &fragmentation) {
+	free = 0;
+	alloc = 0;
+	largestFree = 0;
+	fragmentation = 0;
+	if (EEZ_MUTEX_WAIT(alloc, osWaitForever)) {
+		free = g_freeSize;
+		alloc = g_allocSize;
+		// The largest block is in the highest non-empty list
+		for (unsigned bin = NUM_BINS; bin-- > 0 && largestFree == 0;) {
+			for (AllocBlock *block = g_bins[bin]; block; block = freeLinks(block)->next) {
+				if (block->size > largestFree) {
+					largestFree = block->size;
+				}
 			}
-			block = block->next;
 		}
+		fragmentation = free > 0 ? 100 - (uint32_t)((uint64_t)largestFree * 100 / free) : 0;
 		EEZ_MUTEX_RELEASE(alloc);
 	}
 }
@@ -2112,6 +2308,16 @@ static void PROPERTY_REF_value_to_text(const Value &value, char *text, int count
     snprintf(text, count, "property-ref (flowState=%p, component=%d, property=%d)",
         (void *)value.getPropertyRef()->flowState, value.getPropertyRef()->componentIndex, value.getPropertyRef()->propertyIndex);
 }
+static bool compare_STRING_INLINE_value(const Value &a, const Value &b) {
+	return compare_STRING_value(a, b);
+}
+static void STRING_INLINE_value_to_text(const Value &value, char *text, int count) {
+	STRING_value_to_text(value, text, count);
+}
+static const char *STRING_INLINE_value_type_name(const Value &value) {
+    EEZ_UNUSED(value);
+    return "string";
+}
 static bool compare_DATE_value(const Value &a, const Value &b) {
     return a.type == b.type && a.doubleValue == b.doubleValue;
 }
@@ -2380,6 +2586,9 @@ bool assignValue(Value &dstValue, const Value &srcValue, uint32_t dstValueType)
         dstValue.doubleValue = srcValue.toDouble();
     } else if (dstValue.isString()) {
         dstValue = srcValue.toString(0x30a91156);
+    } else if (srcValue.isConstantArray()) {
+        // Shared by every use of the constant, the destination gets a copy it can write to
+        dstValue = Value(srcValue).clone();
     } else {
         dstValue = srcValue;
     }
@@ -2406,6 +2615,46 @@ Value MakeEnumDefinitionValue(uint8_t enumValue, uint8_t enumDefinition) {
     return value;
 }
 const char *Value::getString() const {
+    if (type == VALUE_TYPE_STRING_INLINE) {
+        return getInlineString();
+    }
+    if (type == VALUE_TYPE_VALUE_PTR) {
+        return pValueValue->getString();
+    }
+    // Indirect values are resolved where the value is kept, an inline string in a temporary would be gone on return
+    if (type == VALUE_TYPE_ARRAY_ELEMENT_VALUE) {
+        auto arrayElementValue = (ArrayElementValue *)refValue;
+        if (arrayElementValue->arrayValue.isArray()) {
+            auto array = arrayElementValue->arrayValue.getArray();
+            if (arrayElementValue->elementIndex < 0 || arrayElementValue->elementIndex >= (int)array->arraySize) {
+                return nullptr;
+            }
+#if defined(EEZ_DASHBOARD_API)
+            if (array->arrayType < flow::defs_v3::FIRST_OBJECT_TYPE || array->arrayType > flow::defs_v3::LAST_OBJECT_TYPE)
+#endif
+            return array->values[arrayElementValue->elementIndex].getString();
+        }
+    }
+    if (type == VALUE_TYPE_PROPERTY_REF) {
+        auto value = evalProperty();
+        if (!value.isString()) {
+            return nullptr;
+        }
+        auto propertyRef = getPropertyRef();
+        propertyRef->stringValue = value;
+        return propertyRef->stringValue.getString();
+    }
+#if defined(EEZ_DASHBOARD_API)
+    if (type == VALUE_TYPE_JSON_MEMBER_VALUE) {
+        auto value = getValue();
+        if (!value.isString()) {
+            return nullptr;
+        }
+        auto jsonMemberValue = (JsonMemberValue *)refValue;
+        jsonMemberValue->stringValue = value;
+        return jsonMemberValue->stringValue.getString();
+    }
+#endif
     auto value = getValue(); 
 	if (value.type == VALUE_TYPE_STRING_REF) {
 		return ((StringRef *)value.refValue)->str;
@@ -2419,18 +2668,12 @@ const ArrayValue *Value::getArray() const {
     if (type == VALUE_TYPE_ARRAY) {
         return arrayValue;
     }
-    if (type == VALUE_TYPE_ARRAY_ASSET) {
-        return (ArrayValue *)((uint8_t *)&int32Value + int32Value);
-    }
     return &((ArrayValueRef *)refValue)->arrayValue;
 }
 ArrayValue *Value::getArray() {
     if (type == VALUE_TYPE_ARRAY) {
         return arrayValue;
     }
-    if (type == VALUE_TYPE_ARRAY_ASSET) {
-        return (ArrayValue *)((uint8_t *)&int32Value + int32Value);
-    }
     return &((ArrayValueRef *)refValue)->arrayValue;
 }
 double Value::toDouble(int *err) const {
@@ -2766,13 +3009,19 @@ Value Value::toString(uint32_t id) const {
 	return makeStringRef(tempStr, strlen(tempStr), id);
 }
 Value Value::makeStringRef(const char *str, int len, uint32_t id) {
+	if (len == -1) {
+		len = strlen(str);
+	}
+    if (EEZ_FOR_LVGL_STRING_INLINE_OPTION && len < (int)VALUE_STRING_INLINE_SIZE) {
+        Value value;
+        value.type = VALUE_TYPE_STRING_INLINE;
+        stringCopyLength(value.getInlineString(), len + 1, str, len);
+        return value;
+    }
     auto stringRef = ObjectAllocator<StringRef>::allocate(id);
 	if (stringRef == nullptr) {
 		return Value(0, VALUE_TYPE_NULL);
 	}
-	if (len == -1) {
-		len = strlen(str);
-	}
     stringRef->str = (char *)alloc(len + 1, id + 1);
     if (stringRef->str == nullptr) {
         ObjectAllocator<StringRef>::deallocate(stringRef);
@@ -2788,11 +3037,18 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
 	return value;
 }
 Value Value::concatenateString(const Value &str1, const Value &str2) {
+    auto newStrLen = strlen(str1.getString()) + strlen(str2.getString()) + 1;
+    if (EEZ_FOR_LVGL_STRING_INLINE_OPTION && newStrLen <= VALUE_STRING_INLINE_SIZE) {
+        Value value;
+        value.type = VALUE_TYPE_STRING_INLINE;
+        stringCopy(value.getInlineString(), newStrLen, str1.getString());
+        stringAppendString(value.getInlineString(), newStrLen, str2.getString());
+        return value;
+    }
     auto stringRef = ObjectAllocator<StringRef>::allocate(0xbab14c6a);;
 	if (stringRef == nullptr) {
 		return Value(0, VALUE_TYPE_NULL);
 	}
-    auto newStrLen = strlen(str1.getString()) + strlen(str2.getString()) + 1;
     stringRef->str = (char *)alloc(newStrLen, 0xb5320162);
     if (stringRef->str == nullptr) {
         ObjectAllocator<StringRef>::deallocate(stringRef);
@@ -2956,29 +3212,58 @@ Value Value::clone() {
     }
     return *this;
 }
+Value::Value(const AssetValue &value)
+    : type(value.type), unit(value.unit), options(value.options), uint64Value(value.uint64Value)
+{
+#if __GNUC__ && defined( __has_warning )
+#   if __has_warning( "-Wdangling-pointer" )
+#       define SUPPRESSING
+#       pragma GCC diagnostic push
+#       pragma GCC diagnostic ignored "-Wdangling-pointer"
+#   endif
+#endif
+    if (value.type == VALUE_TYPE_STRING_ASSET) {
+        type = VALUE_TYPE_STRING;
+        unit = 0;
+        options = 0;
+        strValue = (const char *)((uint8_t *)&value.int32Value + value.int32Value);
+    } else if (value.type == VALUE_TYPE_ARRAY_ASSET) {
+        // The elements are laid out as AssetValues too, so the array can't be used in place
+        auto assetArray = (const AssetArrayValue *)((uint8_t *)&value.int32Value + value.int32Value);
+        type = VALUE_TYPE_UNDEFINED;
+        options = 0;
+        *this = makeArrayRef(assetArray->arraySize, assetArray->arrayType, 0x5a1d3e07);
+        if (type == VALUE_TYPE_ARRAY_REF) {
+            auto array = getArray();
+            for (uint32_t i = 0; i < assetArray->arraySize; i++) {
+                array->values[i] = Value(assetArray->values[i]);
+            }
+        }
+    }
+#ifdef SUPPRESSING
+#   undef SUPPRESSING
+#   pragma GCC diagnostic pop
+#endif
+}
 #if defined(EEZ_OPTION_GUI)
 #if !EEZ_OPTION_GUI
 Value getVar(int16_t id) {
     auto native_var = native_vars[id];
+    auto value = native_var_value((enum NativeVariables)(id - 1));
     if (native_var.type == NATIVE_VAR_TYPE_INTEGER) {
-        auto get = (int32_t (*)())native_var.get;
-        return Value((int)get(), VALUE_TYPE_INT32);
+        return Value((int)*(const int32_t *)value, VALUE_TYPE_INT32);
     }
     if (native_var.type == NATIVE_VAR_TYPE_BOOLEAN) {
-        auto get = (bool (*)())native_var.get;
-        return Value(get(), VALUE_TYPE_BOOLEAN);
+        return Value(*(const bool *)value, VALUE_TYPE_BOOLEAN);
     }
     if (native_var.type == NATIVE_VAR_TYPE_FLOAT) {
-        auto get = (float (*)())native_var.get;
-        return Value(get(), VALUE_TYPE_FLOAT);
+        return Value(*(const float *)value, VALUE_TYPE_FLOAT);
     }
     if (native_var.type == NATIVE_VAR_TYPE_DOUBLE) {
-        auto get = (double (*)())native_var.get;
-        return Value(get(), VALUE_TYPE_DOUBLE);
+        return Value(*(const double *)value, VALUE_TYPE_DOUBLE);
     }
     if (native_var.type == NATIVE_VAR_TYPE_STRING) {
-        auto get = (const char *(*)())native_var.get;
-        return Value(get(), VALUE_TYPE_STRING);
+        return Value((const char *)value, VALUE_TYPE_STRING);
     }
     return Value();
 }
@@ -3354,7 +3639,7 @@ struct ConstantActionComponent : public Component {
 };
 void executeConstantComponent(FlowState *flowState, unsigned componentIndex) {
 	auto component = (ConstantActionComponent *)flowState->flow->components[componentIndex];
-	auto &sourceValue = *flowState->flowDefinition->constants[component->valueIndex];
+	Value sourceValue = getConstant(flowState->flowDefinition, component->valueIndex);
 	propagateValue(flowState, componentIndex, 1, sourceValue);
 	propagateValueThroughSeqout(flowState, componentIndex);
 }
@@ -3962,7 +4247,8 @@ void executeLVGLComponent(FlowState *flowState, unsigned componentIndex) {
                     return;
                 }
                 if (specific->property == IMAGE_IMAGE || specific->property == LABEL_TEXT) {
-                    const char *strValue = value.toString(0xe42b3ca2).getString();
+                    value = value.toString(0xe42b3ca2);
+                    const char *strValue = value.getString();
                     if (specific->property == IMAGE_IMAGE) {
                         const void *src = getLvglImageByNameHook(strValue);
                         if (src) {
@@ -4208,7 +4494,8 @@ void executeLVGLComponent(FlowState *flowState, unsigned componentIndex) {
         return; \
     }\
     propIndex++; \
-    const char *NAME = NAME##Value.toString(0xe42b3ca2).getString();
+    NAME##Value = NAME##Value.toString(0xe42b3ca2); \
+    const char *NAME = NAME##Value.getString();
 #define SCREEN_PROP(NAME) \
     Value NAME##Value; \
     if (!evalExpression(flowState, componentIndex, properties[propIndex]->evalInstructions, NAME##Value, FlowError::PropertyInAction(#NAME, actionName, actionIndex))) { \
@@ -6330,6 +6617,7 @@ static void writeValue(const Value &value) {
 	case VALUE_TYPE_STRING:
     case VALUE_TYPE_STRING_ASSET:
 	case VALUE_TYPE_STRING_REF:
+	case VALUE_TYPE_STRING_INLINE:
 		writeString(value.getString());
 		return;
 	case VALUE_TYPE_ARRAY:
@@ -6370,32 +6658,18 @@ static void writeValue(const Value &value) {
 	writeDebuggerBufferHook(tempStr, strlen(tempStr));
 }
 void onStarted(Assets *assets) {
+    EEZ_UNUSED(assets);
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT)) {
-		auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
-        if (g_globalVariables) {
-            for (uint32_t i = 0; i < g_globalVariables->count; i++) {
-                auto pValue = g_globalVariables->values + i;
-                char buffer[256];
-                snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
-                    MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
-                    (int)i,
-                    (const void *)pValue
-                );
-                writeDebuggerBufferHook(buffer, strlen(buffer));
-                writeValue(*pValue);
-            }
-        } else {
-            for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
-                auto pValue = flowDefinition->globalVariables[i];
-                char buffer[256];
-                snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
-                    MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
-                    (int)i,
-                    (const void *)pValue
-                );
-                writeDebuggerBufferHook(buffer, strlen(buffer));
-                writeValue(*pValue);
-            }
+        for (uint32_t i = 0; i < g_globalVariables->count; i++) {
+            auto pValue = g_globalVariables->values + i;
+            char buffer[256];
+            snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
+                MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
+                (int)i,
+                (const void *)pValue
+            );
+            writeDebuggerBufferHook(buffer, strlen(buffer));
+            writeValue(*pValue);
         }
     }
 }
@@ -6718,6 +6992,60 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 EvalStack g_stack;
+static void pushArrayElement() {
+    auto elementIndexValue = g_stack.pop().getValue();
+    auto arrayValue = g_stack.pop().getValue();
+    if (arrayValue.getType() == VALUE_TYPE_UNDEFINED || arrayValue.getType() == VALUE_TYPE_NULL) {
+        g_stack.push(Value(0, VALUE_TYPE_UNDEFINED));
+    } else {
+        if (arrayValue.isArray()) {
+            auto array = arrayValue.getArray();
+            int err;
+            auto elementIndex = elementIndexValue.toInt32(&err);
+            if (!err) {
+                if (elementIndex >= 0 && elementIndex < (int)array->arraySize) {
+                    g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                } else {
+                    g_stack.push(Value::makeError());
+                    g_stack.setErrorMessage("Array element index out of bounds\n");
+                }
+            } else {
+                g_stack.push(Value::makeError());
+                g_stack.setErrorMessage("Integer value expected for array element index\n");
+            }
+        } else if (arrayValue.isBlob()) {
+            auto blobRef = arrayValue.getBlob();
+            int err;
+            auto elementIndex = elementIndexValue.toInt32(&err);
+            if (!err) {
+                if (elementIndex >= 0 && elementIndex < (int)blobRef->len) {
+                    g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                } else {
+                    g_stack.push(Value::makeError());
+                    g_stack.setErrorMessage("Blob element index out of bounds\n");
+                }
+            } else {
+                g_stack.push(Value::makeError());
+                g_stack.setErrorMessage("Integer value expected for blob element index\n");
+            }
+        } else {
+            g_stack.push(Value::makeError());
+            g_stack.setErrorMessage("Array value expected\n");
+        }
+    }
+}
+static void setDstValueType(uint32_t dstValueType) {
+    if (g_stack.sp == 1) {
+        auto finalResult = g_stack.pop();
+        if (finalResult.getType() == VALUE_TYPE_VALUE_PTR) {
+            finalResult.dstValueType = dstValueType;
+        } else if (finalResult.getType() == VALUE_TYPE_ARRAY_ELEMENT_VALUE) {
+            auto arrayElementValue = (ArrayElementValue *)finalResult.refValue;
+            arrayElementValue->dstValueType = dstValueType;
+        }
+        g_stack.push(finalResult);
+    }
+}
 static void evalExpression(FlowState *flowState, const uint8_t *instructions, int *numInstructionBytes) {
 	auto flowDefinition = flowState->flowDefinition;
 	auto flow = flowState->flow;
@@ -6727,80 +7055,27 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
 		auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
 		auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
 		if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_CONSTANT) {
-			g_stack.push(*flowDefinition->constants[instructionArg]);
+			g_stack.push(getConstant(flowDefinition, instructionArg));
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
 			g_stack.push(flowState->values[instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
 			g_stack.push(&flowState->values[flow->componentInputs.count + instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
 			if ((uint32_t)instructionArg < flowDefinition->globalVariables.count) {
-                if (g_globalVariables) {
-				    g_stack.push(g_globalVariables->values + instructionArg);
-                } else {
-                    g_stack.push(flowDefinition->globalVariables[instructionArg]);
-                }
+				g_stack.push(g_globalVariables->values + instructionArg);
 			} else {
 				g_stack.push(Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE));
 			}
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
 			g_stack.push(Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT));
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_ARRAY_ELEMENT) {
-			auto elementIndexValue = g_stack.pop().getValue();
-			auto arrayValue = g_stack.pop().getValue();
-            if (arrayValue.getType() == VALUE_TYPE_UNDEFINED || arrayValue.getType() == VALUE_TYPE_NULL) {
-                g_stack.push(Value(0, VALUE_TYPE_UNDEFINED));
-            } else {
-                if (arrayValue.isArray()) {
-                    auto array = arrayValue.getArray();
-                    int err;
-                    auto elementIndex = elementIndexValue.toInt32(&err);
-                    if (!err) {
-                        if (elementIndex >= 0 && elementIndex < (int)array->arraySize) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
-                        } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Array element index out of bounds\n");
-                        }
-                    } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for array element index\n");
-                    }
-                } else if (arrayValue.isBlob()) {
-                    auto blobRef = arrayValue.getBlob();
-                    int err;
-                    auto elementIndex = elementIndexValue.toInt32(&err);
-                    if (!err) {
-                        if (elementIndex >= 0 && elementIndex < (int)blobRef->len) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
-                        } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Blob element index out of bounds\n");
-                        }
-                    } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for blob element index\n");
-                    }
-                } else {
-                    g_stack.push(Value::makeError());
-                    g_stack.setErrorMessage("Array value expected\n");
-                }
-            }
+			pushArrayElement();
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
 			g_evalOperations[instructionArg](g_stack);
 		} else {
             if (instruction == EXPR_EVAL_INSTRUCTION_TYPE_END_WITH_DST_VALUE_TYPE) {
     			i += 2;
-                if (g_stack.sp == 1) {
-                    auto finalResult = g_stack.pop();
-                    #define VALUE_TYPE (instructions[i] + (instructions[i + 1] << 8) + (instructions[i + 2] << 16) + (instructions[i + 3] << 24))
-                    if (finalResult.getType() == VALUE_TYPE_VALUE_PTR) {
-                        finalResult.dstValueType = VALUE_TYPE;
-                    } else if (finalResult.getType() == VALUE_TYPE_ARRAY_ELEMENT_VALUE) {
-                        auto arrayElementValue = (ArrayElementValue *)finalResult.refValue;
-                        arrayElementValue->dstValueType = VALUE_TYPE;
-                    }
-                    g_stack.push(finalResult);
-                }
+                setDstValueType(instructions[i] + (instructions[i + 1] << 8) + (instructions[i + 2] << 16) + (instructions[i + 3] << 24));
                 i += 4;
                 break;
             } else {
@@ -6814,11 +7089,339 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
 		*numInstructionBytes = i;
 	}
 }
+// The property expressions of the main assets are decoded by start(), so evaluating a property doesn't
+// re-assemble and dispatch the instruction bytes every time. Each decoded instruction calls its handler
+// with the operand already resolved, the handler returns the next instruction or nullptr at the end.
+// A value pushed right before END or an operation is fused with it into one instruction.
+struct DecodedInstruction;
+typedef const DecodedInstruction *(*DecodedInstructionHandler)(FlowState *flowState, const DecodedInstruction *instruction);
+struct DecodedInstruction {
+    DecodedInstructionHandler handler;
+    union {
+        uint32_t index;                 // Of the input or the local variable in FlowState::values
+        EvalOperation operation;
+        uint32_t dstValueType;
+    };
+    Value value;                        // Constant, global variable pointer, native variable or flow output
+};
+struct DecodedExpression {
+    uint16_t numInstructionBytes;
+    uint16_t numInstructions;
+    DecodedInstruction instructions[1];
+};
+struct DecodedExpressions {
+    FlowDefinition *flowDefinition;
+    uint16_t *flowComponents;           // Per flow, index of its first component in componentProperties
+    uint16_t *componentProperties;      // Per component, index of its first property in properties
+    const DecodedExpression **properties;
+    uint32_t numProperties;
+};
+static DecodedExpressions *g_decodedExpressions;
+// The asset arrays among the constants, converted once into arrays shared by every use of the constant
+static Value *g_arrayConstants;
+static FlowDefinition *g_arrayConstantsFlowDefinition;
+Value getConstant(FlowDefinition *flowDefinition, unsigned constantIndex) {
+    auto constant = flowDefinition->constants[constantIndex];
+    if (constant->type == VALUE_TYPE_ARRAY_ASSET && g_arrayConstants && flowDefinition == g_arrayConstantsFlowDefinition && g_arrayConstants[constantIndex].isArray()) {
+        return g_arrayConstants[constantIndex];
+    }
+    return Value(*constant);
+}
+static void markConstantArray(Value &value) {
+    if (value.type != VALUE_TYPE_ARRAY_REF) {
+        return;
+    }
+    value.options |= ARRAY_OPTIONS_CONSTANT;
+    auto array = value.getArray();
+    for (uint32_t i = 0; i < array->arraySize; i++) {
+        markConstantArray(array->values[i]);
+    }
+}
+static void freeArrayConstants() {
+    auto arrayConstants = g_arrayConstants;
+    if (!arrayConstants) {
+        return;
+    }
+    g_arrayConstants = nullptr;
+    for (uint32_t i = 0; i < g_arrayConstantsFlowDefinition->constants.count; i++) {
+        arrayConstants[i].~Value();
+    }
+    free(arrayConstants);
+}
+static void decodeArrayConstants(FlowDefinition *flowDefinition) {
+    uint32_t numArrays = 0;
+    for (uint32_t i = 0; i < flowDefinition->constants.count; i++) {
+        numArrays += flowDefinition->constants[i]->type == VALUE_TYPE_ARRAY_ASSET;
+    }
+    if (numArrays == 0) {
+        return;
+    }
+    auto arrayConstants = (Value *)alloc(flowDefinition->constants.count * sizeof(Value), 0x7c3e91d4);
+    if (!arrayConstants) {
+        // Converted on every use instead
+        return;
+    }
+    for (uint32_t i = 0; i < flowDefinition->constants.count; i++) {
+        auto constant = flowDefinition->constants[i];
+        new (arrayConstants + i) Value();
+        if (constant->type == VALUE_TYPE_ARRAY_ASSET) {
+            arrayConstants[i] = Value(*constant);
+            markConstantArray(arrayConstants[i]);
+        }
+    }
+    g_arrayConstantsFlowDefinition = flowDefinition;
+    g_arrayConstants = arrayConstants;
+}
+static const DecodedInstruction *decodedPushValue(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(instruction->value);
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedPushInput(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(flowState->values[instruction->index]);
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedPushLocalVar(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(&flowState->values[instruction->index]);
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedArrayElement(FlowState *flowState, const DecodedInstruction *instruction) {
+    pushArrayElement();
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedOperation(FlowState *flowState, const DecodedInstruction *instruction) {
+    instruction->operation(g_stack);
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedEnd(FlowState *flowState, const DecodedInstruction *instruction) {
+    return nullptr;
+}
+static const DecodedInstruction *decodedEndWithDstValueType(FlowState *flowState, const DecodedInstruction *instruction) {
+    setDstValueType(instruction->dstValueType);
+    return nullptr;
+}
+static const DecodedInstruction *decodedPushValueOperation(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(instruction->value);
+    instruction->operation(g_stack);
+    return instruction + 1;
+}
+static const DecodedInstruction *decodedPushValueEnd(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(instruction->value);
+    return nullptr;
+}
+static const DecodedInstruction *decodedPushValueEndWithDstValueType(FlowState *flowState, const DecodedInstruction *instruction) {
+    g_stack.push(instruction->value);
+    setDstValueType(instruction->dstValueType);
+    return nullptr;
+}
+// Properties that are only END, most of them, share this one
+static DecodedExpression g_decodedEmptyExpression = { 2, 1, { { decodedEnd, { 0 }, Value() } } };
+// Decodes the instructions of an expression into `out`, or only counts the decoded instructions if `out` is null
+static unsigned decodeExpression(FlowDefinition *flowDefinition, Flow *flow, const uint8_t *instructions, DecodedExpression *out) {
+    unsigned n = 0;
+    bool pushesValue = false;   // The last decoded instruction only pushes its value and can be fused
+    auto add = [&](DecodedInstructionHandler handler) -> DecodedInstruction * {
+        pushesValue = false;
+        if (!out) {
+            n++;
+            return nullptr;
+        }
+        auto instruction = new (&out->instructions[n++]) DecodedInstruction();
+        instruction->handler = handler;
+        return instruction;
+    };
+    auto fuse = [&](DecodedInstructionHandler handler) -> DecodedInstruction * {
+        pushesValue = false;
+        if (!out) {
+            return nullptr;
+        }
+        auto instruction = &out->instructions[n - 1];
+        instruction->handler = handler;
+        return instruction;
+    };
+	int i = 0;
+	while (true) {
+		uint16_t instruction = instructions[i] + (instructions[i + 1] << 8);
+		auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
+		auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
+        i += 2;
+        DecodedInstruction *decoded;
+		if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_CONSTANT) {
+            if ((decoded = add(decodedPushValue))) {
+                decoded->value = getConstant(flowDefinition, instructionArg);
+            }
+            pushesValue = true;
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
+            if ((decoded = add(decodedPushInput))) {
+                decoded->index = instructionArg;
+            }
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
+            if ((decoded = add(decodedPushLocalVar))) {
+                decoded->index = flow->componentInputs.count + instructionArg;
+            }
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
+            if ((decoded = add(decodedPushValue))) {
+                if ((uint32_t)instructionArg < flowDefinition->globalVariables.count) {
+                    decoded->value = Value(g_globalVariables->values + instructionArg);
+                } else {
+                    decoded->value = Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE);
+                }
+            }
+            pushesValue = true;
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
+            if ((decoded = add(decodedPushValue))) {
+                decoded->value = Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT);
+            }
+            pushesValue = true;
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_ARRAY_ELEMENT) {
+            add(decodedArrayElement);
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
+            if ((decoded = pushesValue ? fuse(decodedPushValueOperation) : add(decodedOperation))) {
+                decoded->operation = g_evalOperations[instructionArg];
+            }
+		} else if (instruction == EXPR_EVAL_INSTRUCTION_TYPE_END_WITH_DST_VALUE_TYPE) {
+            if ((decoded = pushesValue ? fuse(decodedPushValueEndWithDstValueType) : add(decodedEndWithDstValueType))) {
+                decoded->dstValueType = instructions[i] + (instructions[i + 1] << 8) + (instructions[i + 2] << 16) + (instructions[i + 3] << 24);
+            }
+            i += 4;
+            break;
+        } else {
+            pushesValue ? fuse(decodedPushValueEnd) : add(decodedEnd);
+            break;
+		}
+	}
+    if (out) {
+        out->numInstructionBytes = i;
+        out->numInstructions = n;
+    }
+    return n;
+}
+static size_t getDecodedExpressionSize(unsigned numInstructions) {
+    auto size = offsetof(DecodedExpression, instructions) + numInstructions * sizeof(DecodedInstruction);
+    return (size + alignof(DecodedExpression) - 1) & ~(alignof(DecodedExpression) - 1);
+}
+static bool isEmptyExpression(const uint8_t *instructions) {
+    return instructions[0] == (EXPR_EVAL_INSTRUCTION_TYPE_END & 0xFF) && instructions[1] == (EXPR_EVAL_INSTRUCTION_TYPE_END >> 8);
+}
+void freeDecodedExpressions() {
+    freeArrayConstants();
+    auto decodedExpressions = g_decodedExpressions;
+    if (!decodedExpressions) {
+        return;
+    }
+    g_decodedExpressions = nullptr;
+    for (uint32_t i = 0; i < decodedExpressions->numProperties; i++) {
+        auto expression = decodedExpressions->properties[i];
+        if (expression != &g_decodedEmptyExpression) {
+            for (unsigned j = 0; j < expression->numInstructions; j++) {
+                expression->instructions[j].~DecodedInstruction();
+            }
+        }
+    }
+    free(decodedExpressions);
+}
+void decodeExpressions(Assets *assets) {
+    freeDecodedExpressions();
+	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    decodeArrayConstants(flowDefinition);
+    // Sized first, so the tables and the expressions are one allocation
+    uint32_t numComponents = 0;
+    uint32_t numProperties = 0;
+    size_t expressionsSize = 0;
+    for (uint32_t flowIndex = 0; flowIndex < flowDefinition->flows.count; flowIndex++) {
+        auto flow = flowDefinition->flows[flowIndex];
+        numComponents += flow->components.count;
+        for (uint32_t componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+            auto component = flow->components[componentIndex];
+            numProperties += component->properties.count;
+            for (uint32_t i = 0; i < component->properties.count; i++) {
+                auto instructions = component->properties[i]->evalInstructions;
+                if (!isEmptyExpression(instructions)) {
+                    expressionsSize += getDecodedExpressionSize(decodeExpression(flowDefinition, flow, instructions, nullptr));
+                }
+            }
+        }
+    }
+    if (numComponents > 0xFFFF || numProperties > 0xFFFF) {
+        return;
+    }
+    size_t tablesSize = sizeof(DecodedExpressions) + numProperties * sizeof(DecodedExpression *) + (flowDefinition->flows.count + numComponents) * sizeof(uint16_t);
+    tablesSize = (tablesSize + alignof(DecodedExpression) - 1) & ~(alignof(DecodedExpression) - 1);
+    auto decodedExpressions = (DecodedExpressions *)alloc(tablesSize + expressionsSize, 0x2d8c51a3);
+    if (!decodedExpressions) {
+        // Evaluated from the instruction bytes instead
+        return;
+    }
+    decodedExpressions->flowDefinition = flowDefinition;
+    decodedExpressions->numProperties = numProperties;
+    decodedExpressions->properties = (const DecodedExpression **)(decodedExpressions + 1);
+    decodedExpressions->flowComponents = (uint16_t *)(decodedExpressions->properties + numProperties);
+    decodedExpressions->componentProperties = decodedExpressions->flowComponents + flowDefinition->flows.count;
+    auto expression = (uint8_t *)decodedExpressions + tablesSize;
+    uint32_t componentBase = 0;
+    uint32_t propertyBase = 0;
+    for (uint32_t flowIndex = 0; flowIndex < flowDefinition->flows.count; flowIndex++) {
+        auto flow = flowDefinition->flows[flowIndex];
+        decodedExpressions->flowComponents[flowIndex] = componentBase;
+        for (uint32_t componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+            auto component = flow->components[componentIndex];
+            decodedExpressions->componentProperties[componentBase++] = propertyBase;
+            for (uint32_t i = 0; i < component->properties.count; i++) {
+                auto instructions = component->properties[i]->evalInstructions;
+                if (isEmptyExpression(instructions)) {
+                    decodedExpressions->properties[propertyBase++] = &g_decodedEmptyExpression;
+                } else {
+                    auto decodedExpression = (DecodedExpression *)expression;
+                    expression += getDecodedExpressionSize(decodeExpression(flowDefinition, flow, instructions, decodedExpression));
+                    decodedExpressions->properties[propertyBase++] = decodedExpression;
+                }
+            }
+        }
+    }
+    g_decodedExpressions = decodedExpressions;
+}
+static inline const DecodedExpression *getDecodedProperty(FlowState *flowState, int componentIndex, int propertyIndex) {
+    auto decodedExpressions = g_decodedExpressions;
+    if (!decodedExpressions || flowState->flowDefinition != decodedExpressions->flowDefinition) {
+        return nullptr;
+    }
+    auto componentBase = decodedExpressions->flowComponents[flowState->flowIndex];
+    return decodedExpressions->properties[decodedExpressions->componentProperties[componentBase + componentIndex] + propertyIndex];
+}
+static void evalExpression(FlowState *flowState, const uint8_t *instructions, const DecodedExpression *expression, int *numInstructionBytes) {
+    if (!expression) {
+        evalExpression(flowState, instructions, numInstructionBytes);
+        return;
+    }
+    auto instruction = expression->instructions;
+    do {
+        instruction = instruction->handler(flowState, instruction);
+    } while (instruction);
+	if (numInstructionBytes) {
+		*numInstructionBytes = expression->numInstructionBytes;
+	}
+}
 #if EEZ_OPTION_GUI
-bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators, DataOperationEnum operation) {
+static bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, const DecodedExpression *expression, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators, DataOperationEnum operation) {
 #else
-bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
+static bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, const DecodedExpression *expression, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
 #endif
+    if (expression && expression->instructions[0].handler == decodedPushValueEnd
+#if EEZ_OPTION_GUI
+        && operation == DATA_OPERATION_GET
+#endif
+    ) {
+        // Only the value, e.g. a native variable bound to a label, it doesn't need the stack
+        result = expression->instructions[0].value.getValue();
+        if (numInstructionBytes) {
+            *numInstructionBytes = expression->numInstructionBytes;
+        }
+        if (!result.isError()) {
+            return true;
+        }
+        FlowError flowError = errorMessage.setDescription(g_stack.errorMessage);
+        throwError(flowState, componentIndex, flowError);
+        return false;
+    }
     size_t savedSp = g_stack.sp;
     FlowState *savedFlowState = g_stack.flowState;
 	int savedComponentIndex = g_stack.componentIndex;
@@ -6828,7 +7431,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
 	g_stack.componentIndex = componentIndex;
 	g_stack.iterators = iterators;
     g_stack.errorMessage = nullptr;
-	evalExpression(flowState, instructions, numInstructionBytes);
+	evalExpression(flowState, instructions, expression, numInstructionBytes);
 	g_stack.flowState = savedFlowState;
 	g_stack.componentIndex = savedComponentIndex;
 	g_stack.iterators = savedIterators;
@@ -6882,7 +7485,16 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
     throwError(flowState, componentIndex, flowError);
 	return false;
 }
-bool evalAssignableExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
+#if EEZ_OPTION_GUI
+bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators, DataOperationEnum operation) {
+    return evalExpression(flowState, componentIndex, instructions, nullptr, result, errorMessage, numInstructionBytes, iterators, operation);
+}
+#else
+bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
+    return evalExpression(flowState, componentIndex, instructions, nullptr, result, errorMessage, numInstructionBytes, iterators);
+}
+#endif
+static bool evalAssignableExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, const DecodedExpression *expression, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
     FlowState *savedFlowState = g_stack.flowState;
 	int savedComponentIndex = g_stack.componentIndex;
 	const int32_t *savedIterators = g_stack.iterators;
@@ -6891,7 +7503,7 @@ bool evalAssignableExpression(FlowState *flowState, int componentIndex, const ui
 	g_stack.componentIndex = componentIndex;
 	g_stack.iterators = iterators;
     g_stack.errorMessage = nullptr;
-	evalExpression(flowState, instructions, numInstructionBytes);
+	evalExpression(flowState, instructions, expression, numInstructionBytes);
 	g_stack.flowState = savedFlowState;
 	g_stack.componentIndex = savedComponentIndex;
 	g_stack.iterators = savedIterators;
@@ -6913,6 +7525,9 @@ bool evalAssignableExpression(FlowState *flowState, int componentIndex, const ui
     throwError(flowState, componentIndex, errorMessage);
 	return false;
 }
+bool evalAssignableExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
+    return evalAssignableExpression(flowState, componentIndex, instructions, nullptr, result, errorMessage, numInstructionBytes, iterators);
+}
 #if EEZ_OPTION_GUI
 bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators, DataOperationEnum operation) {
 #else
@@ -6934,9 +7549,9 @@ bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, V
         return false;
     }
 #if EEZ_OPTION_GUI
-    return evalExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators, operation);
+    return evalExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, getDecodedProperty(flowState, componentIndex, propertyIndex), result, errorMessage, numInstructionBytes, iterators, operation);
 #else
-    return evalExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators);
+    return evalExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, getDecodedProperty(flowState, componentIndex, propertyIndex), result, errorMessage, numInstructionBytes, iterators);
 #endif
 }
 bool evalAssignableProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
@@ -6955,7 +7570,7 @@ bool evalAssignableProperty(FlowState *flowState, int componentIndex, int proper
         throwError(flowState, componentIndex, flowError);
         return false;
     }
-    return evalAssignableExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators);
+    return evalAssignableExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, getDecodedProperty(flowState, componentIndex, propertyIndex), result, errorMessage, numInstructionBytes, iterators);
 }
 #if EEZ_OPTION_GUI
 int16_t getNativeVariableId(const WidgetCursor &widgetCursor) {
@@ -7025,6 +7640,7 @@ unsigned start(Assets *assets) {
     g_isStopped = false;
     g_isStopping = false;
     initGlobalVariables(assets);
+    decodeExpressions(assets);
 	queueReset();
     watchListReset();
 	scpiComponentInitHook();
@@ -7103,6 +7719,7 @@ void doStop() {
     g_firstFlowState = nullptr;
     g_lastFlowState = nullptr;
     g_isStopped = true;
+    freeDecodedExpressions();
 	queueReset();
     watchListReset();
 }
@@ -7185,7 +7802,7 @@ Value getGlobalVariable(uint32_t globalVariableIndex) {
 }
 Value getGlobalVariable(Assets *assets, uint32_t globalVariableIndex) {
     if (globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        return g_globalVariables ? g_globalVariables->values[globalVariableIndex] : *assets->flowDefinition->globalVariables[globalVariableIndex];
+        return g_globalVariables->values[globalVariableIndex];
     }
     return Value();
 }
@@ -7194,11 +7811,7 @@ void setGlobalVariable(uint32_t globalVariableIndex, const Value &value) {
 }
 void setGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value) {
     if (globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        if (g_globalVariables) {
-            g_globalVariables->values[globalVariableIndex] = value;
-        } else {
-            *assets->flowDefinition->globalVariables[globalVariableIndex] = value;
-        }
+        g_globalVariables->values[globalVariableIndex] = value;
     }
 }
 Value getUserProperty(unsigned propertyIndex) {
@@ -7808,7 +8421,14 @@ void eez_flow_init_style_names(const char **styleNames, size_t numStyles) {
     g_numStyles = numStyles;
 }
 extern "C" void eez_flow_tick() {
+    eez::g_allocStats.ticks++;
+    const bool busy = eez::flow::getQueueSize() > 0;
     eez::flow::tick();
+    // Once the queue has run, one more tick lets the watch list see what it changed
+    __atomic_store_n(&eez::flow::g_tickNeeded, busy || eez::flow::getQueueSize() > 0, __ATOMIC_RELAXED);
+}
+extern "C" bool eez_flow_tick_needed() {
+    return __atomic_load_n(&eez::flow::g_tickNeeded, __ATOMIC_RELAXED);
 }
 extern "C" bool eez_flow_is_stopped() {
     return eez::flow::isFlowStopped();
@@ -7906,6 +8526,47 @@ extern "C" const char *_evalTextProperty(void *flowState, unsigned componentInde
     value.toText(textValue, sizeof(textValue));
     return textValue;
 }
+static eez_text_cache_stats_t g_textCacheStats;
+extern "C" const char *_evalTextPropertyCached(void *flowState, unsigned componentIndex, unsigned propertyIndex, eez_text_cache_t *cache, const char *errorMessage, const char *file, int line) {
+    eez::Value value;
+    if (!eez::flow::evalProperty((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, eez::flow::FlowError::Plain(errorMessage, file, line))) {
+        cache->valid = false;
+        return "";
+    }
+    // Only numbers are cached, the bits of a string are a pointer that says nothing about its content
+    bool cacheable = value.isInt32OrLess() || value.isInt64() || value.isFloat() || value.isDouble();
+    uint64_t bits = 0;
+    if (value.isInt64() || value.isDouble()) {
+        bits = value.uint64Value;
+    } else if (value.isFloat()) {
+        bits = value.uint32Value;
+    } else if (cacheable) {
+        bits = (uint32_t)value.toInt32();
+    }
+    if (cacheable && cache->valid && cache->type == value.type && cache->unit == value.unit && cache->bits == bits) {
+        __atomic_store_n(&g_textCacheStats.hits, g_textCacheStats.hits + 1, __ATOMIC_RELAXED);
+        return nullptr;
+    }
+    __atomic_store_n(&g_textCacheStats.misses, g_textCacheStats.misses + 1, __ATOMIC_RELAXED);
+    cache->valid = cacheable;
+    cache->type = value.type;
+    cache->unit = value.unit;
+    cache->bits = bits;
+    value.toText(textValue, sizeof(textValue));
+    return textValue;
+}
+extern "C" void eez_flow_get_text_cache_stats(eez_text_cache_stats_t *stats) {
+    stats->hits = __atomic_load_n(&g_textCacheStats.hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&g_textCacheStats.misses, __ATOMIC_RELAXED);
+}
+extern "C" void eez_flow_get_alloc_stats(eez_alloc_stats_t *stats) {
+    // Written by the LVGL task, the fields may be an allocation apart
+    *stats = eez::g_allocStats;
+    for (int i = 0; i < EEZ_ALLOC_SIZE_CLASSES; i++) {
+        stats->classes[i].block_size = eez::SLAB_MIN_BLOCK_SIZE << i;
+    }
+    stats->arena_size = eez::SLAB_PAGES * eez::SLAB_PAGE_SIZE;
+}
 extern "C" int32_t _evalIntegerProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *file, int line) {
     eez::Value value;
     if (!eez::flow::evalProperty((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, eez::flow::FlowError::Plain(errorMessage, file, line))) {
@@ -10392,9 +11053,7 @@ inline Value getEmptyInputValue() {
     return emptyInputValue;
 }
 void initGlobalVariables(Assets *assets) {
-    if (!g_mainAssetsUncompressed) {
-        return;
-    }
+    // Always copied out of the assets, they lay values out differently
 	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
     auto numVars = flowDefinition->globalVariables.count;
     g_globalVariables = (GlobalVariables *) alloc(
@@ -10402,9 +11061,10 @@ void initGlobalVariables(Assets *assets) {
         (numVars > 0 ? numVars - 1 : 0) * sizeof(Value),
         0xcc34ca8e
     );
+    g_globalVariables->count = numVars;
     for (uint32_t i = 0; i < numVars; i++) {
 		new (g_globalVariables->values + i) Value();
-        g_globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
+        g_globalVariables->values[i] = Value(*flowDefinition->globalVariables[i]).clone();
 	}
 }
 static bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
@@ -10690,7 +11350,7 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
 	}
 }
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex) {
-	auto &nullValue = *flowState->flowDefinition->constants[NULL_VALUE_INDEX];
+	Value nullValue = *flowState->flowDefinition->constants[NULL_VALUE_INDEX];
 	propagateValue(flowState, componentIndex, outputIndex, nullValue);
 }
 void propagateValueThroughSeqout(FlowState *flowState, unsigned componentIndex) {
@@ -10762,6 +11422,14 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
                 }
                 return;
             } else {
+                if (arrayElementValue->arrayValue.isConstantArray()) {
+                    // Written through a copy, the constant stays as it is in the assets
+                    arrayElementValue->arrayValue = arrayElementValue->arrayValue.clone();
+                    if (!arrayElementValue->arrayValue.isArray()) {
+                        throwError(flowState, componentIndex, FlowError::Plain("Can not assign, out of memory"));
+                        return;
+                    }
+                }
                 auto array = arrayElementValue->arrayValue.getArray();
                 if (arrayElementValue->elementIndex < 0 || arrayElementValue->elementIndex >= (int)array->arraySize) {
                     throwError(flowState, componentIndex, FlowError::Plain("Can not assign, array element index out of bounds"));
@@ -11071,6 +11739,7 @@ static unsigned g_queueTail;
 static unsigned g_queueMax;
 static bool g_queueIsFull = false;
 unsigned g_numNonContinuousTaskInQueue;
+bool g_tickNeeded;
 void queueReset() {
 	g_queueHead = 0;
 	g_queueTail = 0;
@@ -11112,6 +11781,7 @@ bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceCompone
 	    onAddToQueue(flowState, sourceComponentIndex, sourceOutputIndex, componentIndex, targetInputIndex);
     }
     incRefCounterForFlowState(flowState);
+    __atomic_store_n(&g_tickNeeded, true, __ATOMIC_RELAXED);
 	return true;
 }
 bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
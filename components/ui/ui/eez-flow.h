@@ -13,6 +13,10 @@
 #define EEZ_FOR_LVGL 1
 #define EEZ_FOR_LVGL_LZ4_OPTION 0
 #define EEZ_FOR_LVGL_SHA256_OPTION 0
+// Set to 0 to give every string a StringRef instead of keeping short ones inline in the Value
+#ifndef EEZ_FOR_LVGL_STRING_INLINE_OPTION
+#define EEZ_FOR_LVGL_STRING_INLINE_OPTION 1
+#endif
 #define EEZ_FLOW_QUEUE_SIZE 1000
 #define EEZ_FLOW_EVAL_STACK_SIZE 20
 
@@ -190,6 +194,7 @@ Unit getSmallestUnit(Unit unit, float min, float precision);
     VALUE_TYPE(JSON_MEMBER_VALUE)                   \
     VALUE_TYPE(EVENT)                               \
     VALUE_TYPE(PROPERTY_REF)                        \
+    VALUE_TYPE(STRING_INLINE)                       \
     CUSTOM_VALUE_TYPES
 namespace eez {
 #define VALUE_TYPE(NAME) VALUE_TYPE_##NAME,
@@ -225,6 +230,7 @@ template<class T> struct ObjectAllocator {
 void dumpAlloc(scpi_t *context);
 #endif
 void getAllocInfo(uint32_t &free, uint32_t &alloc);
+void getAllocInfo(uint32_t &free, uint32_t &alloc, uint32_t &largestFree, uint32_t &fragmentation);
 } 
 // -----------------------------------------------------------------------------
 // flow/flow_defs_v3.h
@@ -871,6 +877,7 @@ enum ArrayTypes {
 // -----------------------------------------------------------------------------
 // core/value.h
 // -----------------------------------------------------------------------------
+#include <stddef.h>
 #include <string.h>
 namespace eez {
 namespace flow {
@@ -892,6 +899,7 @@ struct EnumValue {
 };
 #define VALUE_OPTIONS_REF (1 << 0)
 #define STRING_OPTIONS_FILE_ELLIPSIS (1 << 1)
+#define ARRAY_OPTIONS_CONSTANT (1 << 1)
 #define FLOAT_OPTIONS_LESS_THEN (1 << 1)
 #define FLOAT_OPTIONS_FIXED_DECIMALS (1 << 2)
 #define FLOAT_OPTIONS_GET_NUM_FIXED_DECIMALS(options) (((options) >> 3) & 0b111)
@@ -933,104 +941,109 @@ namespace flow {
     extern void dashboardObjectValueDecRef(int json);
 }
 #endif
+struct AssetValue;
+// Values are packed into 12 bytes, 4-byte aligned, as the flow state, the eval stack and the arrays hold a lot
+// of them. The assets keep the 16 bytes layout of the studio, see AssetValue.
+#pragma pack(push, 4)
 struct Value {
   public:
     Value()
-        : type(VALUE_TYPE_UNDEFINED), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint64Value(0)
+        : type(VALUE_TYPE_UNDEFINED), unit(UNIT_UNKNOWN), options(0), uint64Value(0)
     {
     }
 	Value(int value)
-        : type(VALUE_TYPE_INT32), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), int32Value(value)
+        : type(VALUE_TYPE_INT32), unit(UNIT_UNKNOWN), options(0), int32Value(value)
     {
     }
 	Value(const char *str)
-        : type(VALUE_TYPE_STRING), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), strValue(str)
+        : type(VALUE_TYPE_STRING), unit(UNIT_UNKNOWN), options(0), strValue(str)
     {
     }
 	Value(uint8_t version, const char *str)
-        : type(VALUE_TYPE_VERSIONED_STRING), unit(version), options(0), dstValueType(VALUE_TYPE_UNDEFINED), strValue(str)
+        : type(VALUE_TYPE_VERSIONED_STRING), unit(version), options(0), strValue(str)
     {
     }
 	Value(Value *pValue)
-		: type(VALUE_TYPE_VALUE_PTR), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), pValueValue(pValue)
+		: type(VALUE_TYPE_VALUE_PTR), dstValueType(VALUE_TYPE_UNDEFINED), options(0), pValueValue(pValue)
     {
 	}
     Value(const char *str, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), strValue(str)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), strValue(str)
     {
     }
     Value(int value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), int32Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), int32Value(value)
     {
     }
     Value(int value, ValueType type_, uint16_t options_)
-        : type(type_), unit(UNIT_UNKNOWN), options(options_), dstValueType(VALUE_TYPE_UNDEFINED), int32Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(options_), int32Value(value)
     {
     }
     Value(int8_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), int8Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), int8Value(value)
     {
     }
     Value(uint8_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint8Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), uint8Value(value)
     {
     }
     Value(int16_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), int16Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), int16Value(value)
     {
     }
     Value(uint16_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint16Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), uint16Value(value)
     {
     }
     Value(uint32_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint32Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), uint32Value(value)
     {
     }
     Value(int64_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), int64Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), int64Value(value)
     {
     }
     Value(uint64_t value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint64Value(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), uint64Value(value)
     {
     }
     Value(float value, Unit unit_)
-        : type(VALUE_TYPE_FLOAT), unit(unit_), options(0), dstValueType(VALUE_TYPE_UNDEFINED), floatValue(value)
+        : type(VALUE_TYPE_FLOAT), unit(unit_), options(0), floatValue(value)
     {
     }
     Value(float value, Unit unit_, uint16_t options_)
-        : type(VALUE_TYPE_FLOAT), unit(unit_), options(options_), dstValueType(VALUE_TYPE_UNDEFINED), floatValue(value)
+        : type(VALUE_TYPE_FLOAT), unit(unit_), options(options_), floatValue(value)
     {
     }
     Value(float value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), floatValue(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), floatValue(value)
     {
     }
 	Value(double value, ValueType type_)
-		: type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), doubleValue(value) {
+		: type(type_), unit(UNIT_UNKNOWN), options(0), doubleValue(value) {
 	}
 	Value(const char *value, ValueType type_, uint16_t options_)
-        : type(type_), unit(UNIT_UNKNOWN), options(options_), dstValueType(VALUE_TYPE_UNDEFINED), strValue(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(options_), strValue(value)
     {
     }
     Value(void *value, ValueType type_)
-        : type(type_), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), pVoidValue(value)
+        : type(type_), unit(UNIT_UNKNOWN), options(0), pVoidValue(value)
     {
     }
     typedef float (*YtDataGetValueFunctionPointer)(uint32_t rowIndex, uint8_t columnIndex, float *max);
     Value(YtDataGetValueFunctionPointer ytDataGetValueFunctionPointer)
-        : type(VALUE_TYPE_YT_DATA_GET_VALUE_FUNCTION_POINTER), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), pVoidValue((void *)ytDataGetValueFunctionPointer)
+        : type(VALUE_TYPE_YT_DATA_GET_VALUE_FUNCTION_POINTER), unit(UNIT_UNKNOWN), options(0), pVoidValue((void *)ytDataGetValueFunctionPointer)
     {
     }
 	Value(const Value& value)
-		: type(VALUE_TYPE_UNDEFINED), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), uint64Value(0)
+		: type(VALUE_TYPE_UNDEFINED), unit(UNIT_UNKNOWN), options(0), uint64Value(0)
 	{
 		*this = value;
 	}
+	Value(const AssetValue& value);
 #if EEZ_OPTION_GUI
     Value(AppContext *appContext)
-        : type(VALUE_TYPE_POINTER), unit(UNIT_UNKNOWN), options(0), dstValueType(VALUE_TYPE_UNDEFINED), pVoidValue(appContext)
+        : type(VALUE_TYPE_POINTER), unit(UNIT_UNKNOWN), options(0), pVoidValue(appContext)
     {
     }
 #endif
@@ -1038,7 +1051,7 @@ struct Value {
         freeRef();
 	}
     void freeRef() {
-		if (options & VALUE_OPTIONS_REF) {
+		if (isRef()) {
 			if (--refValue->refCounter == 0) {
                 ObjectAllocator<Ref>::deallocate(refValue);
 			}
@@ -1051,53 +1064,18 @@ struct Value {
     }
     Value& operator = (const Value &value) {
         freeRef();
-        if (value.type == VALUE_TYPE_STRING_ASSET) {
-            type = VALUE_TYPE_STRING;
-            unit = 0;
-            options = 0;
-#if __GNUC__ && defined( __has_warning )
-#   if __has_warning( "-Wdangling-pointer" )
-#       define SUPPRESSING
-#       pragma GCC diagnostic push
-#       pragma GCC diagnostic ignored "-Wdangling-pointer"
-#   endif
-#endif
-            strValue = (const char *)((uint8_t *)&value.int32Value + value.int32Value);
-#ifdef SUPPRESSING
-#   undef SUPPRESSING
-#   pragma GCC diagnostic pop
-#endif
-        } else if (value.type == VALUE_TYPE_ARRAY_ASSET) {
-            type = VALUE_TYPE_ARRAY;
-            unit = 0;
-            options = 0;
-#if __GNUC__ && defined( __has_warning )
-#   if __has_warning( "-Wdangling-pointer" )
-#       define SUPPRESSING
-#       pragma GCC diagnostic push
-#       pragma GCC diagnostic ignored "-Wdangling-pointer"
-#   endif
-#endif
-            arrayValue = (ArrayValue *)((uint8_t *)&value.int32Value + value.int32Value);
-#ifdef SUPPRESSING
-#   undef SUPPRESSING
-#   pragma GCC diagnostic pop
-#endif
-        } else {
-            type = value.type;
-            unit = value.unit;
-            options = value.options;
-            dstValueType = value.dstValueType;
-            memcpy((void *)&int64Value, (const void *)&value.int64Value, sizeof(int64_t));
-            if (options & VALUE_OPTIONS_REF) {
-                refValue->refCounter++;
-            } 
+        type = value.type;
+        unit = value.unit;
+        options = value.options;
+        memcpy((void *)&int64Value, (const void *)&value.int64Value, sizeof(int64_t));
+        if (isRef()) {
+            refValue->refCounter++;
+        } 
 #if defined(EEZ_DASHBOARD_API)
-            if (type == VALUE_TYPE_JSON || type == VALUE_TYPE_STREAM) {
-                flow::dashboardObjectValueIncRef(value.int32Value);;
-            }
-#endif
+        if (type == VALUE_TYPE_JSON || type == VALUE_TYPE_STREAM) {
+            flow::dashboardObjectValueIncRef(value.int32Value);;
         }
+#endif
         return *this;
     }
     bool operator==(const Value &other) const {
@@ -1144,10 +1122,13 @@ struct Value {
 		return type == VALUE_TYPE_BOOLEAN;
 	}
 	bool isString() const {
-        return type == VALUE_TYPE_STRING || type == VALUE_TYPE_STRING_ASSET || type == VALUE_TYPE_STRING_REF;
+        return type == VALUE_TYPE_STRING || type == VALUE_TYPE_STRING_ASSET || type == VALUE_TYPE_STRING_REF || type == VALUE_TYPE_STRING_INLINE;
     }
     bool isArray() const {
         return type == VALUE_TYPE_ARRAY || type == VALUE_TYPE_ARRAY_ASSET || type == VALUE_TYPE_ARRAY_REF;
+    }
+    bool isConstantArray() const {
+        return type == VALUE_TYPE_ARRAY_REF && (options & ARRAY_OPTIONS_CONSTANT);
     }
 	bool isBlob() const {
         return type == VALUE_TYPE_BLOB_REF;
@@ -1291,9 +1272,13 @@ struct Value {
     Value clone();
   public:
 	uint8_t type;
-	uint8_t unit;
+    union {
+	    uint8_t unit;
+        // VALUE_PTR results of an assignable expression, the type the assigned value is converted to. ARRAY_ELEMENT_VALUE
+        // results keep it in ArrayElementValue.
+        uint8_t dstValueType;
+    };
 	uint16_t options;
-    uint32_t dstValueType;
     union {
 		int8_t int8Value;
 		uint8_t uint8Value;
@@ -1317,6 +1302,36 @@ struct Value {
 		PairOfUint16Value pairOfUint16Value;
 		PairOfInt16Value pairOfInt16Value;
 	};
+  private:
+    // A VALUE_TYPE_STRING_INLINE string is stored in the value itself, from unit to the end of the payload
+    char *getInlineString() const {
+        return (char *)this + offsetof(Value, unit);
+    }
+    // The options of an inline string hold characters, not the reference flag
+    bool isRef() const {
+        return (options & VALUE_OPTIONS_REF) && type != VALUE_TYPE_STRING_INLINE;
+    }
+};
+#pragma pack(pop)
+static_assert(sizeof(Value) == 12, "eez::Value is expected to be 12 bytes");
+// Strings shorter than this (with the terminating zero) are kept in the Value instead of a StringRef, they
+// cost no allocation and no reference counting. getString() of such a value is only valid as long as the value.
+static const size_t VALUE_STRING_INLINE_SIZE = sizeof(Value) - offsetof(Value, unit);
+// A value as the studio lays it out in the assets, converted to a Value when it's read
+struct AssetValue {
+	uint8_t type;
+	uint8_t unit;
+	uint16_t options;
+    uint32_t reserved;
+    union {
+		int32_t int32Value;
+		uint64_t uint64Value;
+	};
+};
+struct AssetArrayValue {
+	uint32_t arraySize;
+    uint32_t arrayType;
+	AssetValue values[1];
 };
 struct StringRef : public Ref {
     ~StringRef() {
@@ -1359,6 +1374,7 @@ struct PropertyRef : public Ref {
 	flow::FlowState *flowState;
     int componentIndex;
     int propertyIndex;
+    Value stringValue; // Last evaluation read by getString(), the string stays valid as long as the reference
 };
 struct ArrayElementValue : public Ref {
 	Value arrayValue;
@@ -1368,6 +1384,7 @@ struct ArrayElementValue : public Ref {
 struct JsonMemberValue : public Ref {
 	Value jsonValue;
     Value propertyName;
+    Value stringValue; // Last member read by getString(), the string stays valid as long as the reference
 };
 #if EEZ_OPTION_GUI
 namespace gui {
@@ -1863,7 +1880,7 @@ struct WidgetActionItem {
 typedef uint8_t ComponentInput;
 struct Flow {
 	ListOfAssetsPtr<Component> components;
-	ListOfAssetsPtr<Value> localVariables;
+	ListOfAssetsPtr<AssetValue> localVariables;
 	ListOfFundamentalType<ComponentInput> componentInputs;
 	ListOfAssetsPtr<WidgetDataItem> widgetDataItems;
 	ListOfAssetsPtr<WidgetActionItem> widgetActions;
@@ -1871,8 +1888,8 @@ struct Flow {
 };
 struct FlowDefinition {
 	ListOfAssetsPtr<Flow> flows;
-	ListOfAssetsPtr<Value> constants;
-	ListOfAssetsPtr<Value> globalVariables;
+	ListOfAssetsPtr<AssetValue> constants;
+	ListOfAssetsPtr<AssetValue> globalVariables;
 };
 struct Language {
     AssetsPtr<const char> languageID;
@@ -2607,6 +2624,9 @@ bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, V
 bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes = nullptr, const int32_t *iterators = nullptr);
 #endif
 bool evalAssignableProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes = nullptr, const int32_t *iterators = nullptr);
+void decodeExpressions(Assets *assets);
+void freeDecodedExpressions();
+Value getConstant(FlowDefinition *flowDefinition, unsigned constantIndex);
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -2729,6 +2749,7 @@ void queueReset();
 size_t getQueueSize();
 size_t getMaxQueueSize();
 extern unsigned g_numNonContinuousTaskInQueue;
+extern bool g_tickNeeded; // Set when a task is queued, cleared by a tick that leaves nothing to do
 bool addToQueue(FlowState *flowState, unsigned componentIndex,
     int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex,
     bool continuousTask);
@@ -3041,6 +3062,7 @@ void eez_flow_init_themes(const char **themeNames, size_t numThemes, void (*chan
 void eez_flow_set_create_screen_func(void (*createScreenFunc)(int screenIndex));
 void eez_flow_set_delete_screen_func(void (*deleteScreenFunc)(int screenIndex));
 void eez_flow_tick();
+bool eez_flow_tick_needed();
 bool eez_flow_is_stopped();
 extern int16_t g_currentScreen;
 int16_t eez_flow_get_current_screen();
@@ -3059,6 +3081,7 @@ void flowPropagateValueInt32(void *flowState, unsigned componentIndex, unsigned
 void flowPropagateValueUint32(void *flowState, unsigned componentIndex, unsigned outputIndex, uint32_t value);
 void flowPropagateValueLVGLEvent(void *flowState, unsigned componentIndex, unsigned outputIndex, lv_event_t *event);
 #define evalTextProperty(flowState, componentIndex, propertyIndex, errorMessage) _evalTextProperty(flowState, componentIndex, propertyIndex, errorMessage, __FILE__, __LINE__)
+#define evalTextPropertyCached(flowState, componentIndex, propertyIndex, cache, errorMessage) _evalTextPropertyCached(flowState, componentIndex, propertyIndex, cache, errorMessage, __FILE__, __LINE__)
 #define evalIntegerProperty(flowState, componentIndex, propertyIndex, errorMessage) _evalIntegerProperty(flowState, componentIndex, propertyIndex, errorMessage, __FILE__, __LINE__)
 #define evalUnsignedIntegerProperty(flowState, componentIndex, propertyIndex, errorMessage) _evalUnsignedIntegerProperty(flowState, componentIndex, propertyIndex, errorMessage, __FILE__, __LINE__)
 #define evalBooleanProperty(flowState, componentIndex, propertyIndex, errorMessage) _evalBooleanProperty(flowState, componentIndex, propertyIndex, errorMessage, __FILE__, __LINE__)
@@ -3067,6 +3090,36 @@ void flowPropagateValueLVGLEvent(void *flowState, unsigned componentIndex, unsig
 #define assignIntegerProperty(flowState, componentIndex, propertyIndex, value, errorMessage) _assignIntegerProperty(flowState, componentIndex, propertyIndex, value, errorMessage, __FILE__, __LINE__)
 #define assignBooleanProperty(flowState, componentIndex, propertyIndex, value, errorMessage) _assignBooleanProperty(flowState, componentIndex, propertyIndex, value, errorMessage, __FILE__, __LINE__) 
 const char *_evalTextProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *file, int line);
+typedef struct {
+    bool valid;
+    uint8_t type;
+    uint8_t unit;
+    uint64_t bits;
+} eez_text_cache_t;
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+} eez_text_cache_stats_t;
+const char *_evalTextPropertyCached(void *flowState, unsigned componentIndex, unsigned propertyIndex, eez_text_cache_t *cache, const char *errorMessage, const char *file, int line);
+void eez_flow_get_text_cache_stats(eez_text_cache_stats_t *stats);
+#define EEZ_ALLOC_SIZE_CLASSES 5
+typedef struct {
+    uint32_t block_size;
+    uint32_t blocks;
+    uint32_t used;
+    uint32_t peak;
+} eez_alloc_class_stats_t;
+typedef struct {
+    eez_alloc_class_stats_t classes[EEZ_ALLOC_SIZE_CLASSES];
+    uint32_t arena_size;
+    uint32_t arena_used;
+    uint32_t heap_blocks;
+    uint32_t heap_allocs;
+    uint32_t allocs;
+    uint32_t alloc_bytes;
+    uint32_t ticks;
+} eez_alloc_stats_t;
+void eez_flow_get_alloc_stats(eez_alloc_stats_t *stats);
 int32_t _evalIntegerProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *file, int line);
 uint32_t _evalUnsignedIntegerProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *file, int line);
 bool _evalBooleanProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *file, int line);
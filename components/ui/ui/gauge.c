@@ -0,0 +1,430 @@
+#include <math.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include <src/draw/sw/lv_draw_sw.h>
+
+#include "gauge.h"
+
+#define GAUGE_ANGLE_SCALE (16)      // Pixel angles are stored in 1/16 degree
+#define GAUGE_ANGLE_NONE (0xffff)   // Angle of the pixels of the rounded ends beyond the background arc
+#define GAUGE_MASK_SIZE (GAUGE_SIZE_MAX + 3)
+
+// Consecutive pixels of a row covered by a ring
+typedef struct {
+    int16_t x;          // Of the first pixel, relative to the centre
+    uint16_t len;
+    uint32_t offset;    // Of the first pixel in the coverage and angle maps
+} gauge_span_t;
+
+// Geometry a ring is rasterised for
+typedef struct {
+    lv_coord_t radius;
+    lv_coord_t width;
+    int16_t start;      // Start of the background arc, rotation included
+    uint16_t span;      // Angle of the background arc, 360 for a full ring
+    bool rounded;
+} gauge_key_t;
+
+// Pre-rendered ring of one part, in a single allocation
+typedef struct {
+    gauge_key_t key;
+    lv_coord_t extent;      // Rows and columns reach from -extent to extent around the centre
+    uint32_t size;
+    gauge_span_t *spans;
+    uint16_t *rows;         // First span of each row, and the end of the last row
+    uint16_t *angles;       // Angle of each covered pixel from the start of the background arc
+    lv_opa_t *coverage;     // Anti-aliased coverage of each covered pixel
+} gauge_shape_t;
+
+// How a part is drawn in the current refresh, captured from LV_EVENT_DRAW_PART_BEGIN
+typedef struct {
+    gauge_shape_t *shape;
+    lv_point_t center;
+    lv_color_t color;
+    lv_opa_t opa;
+    lv_blend_mode_t blend_mode;
+    bool drawn;             // lv_draw_arc() was skipped for this part and it's composited instead
+} gauge_part_t;
+
+typedef struct {
+    gauge_part_t bg;
+    gauge_part_t indic;
+    bool failed;            // A shape couldn't be allocated, lv_arc draws the gauge from now on
+    int16_t drawn_value;    // Value of the last draw
+    int64_t draw_start;
+} gauge_t;
+
+static gauge_stats_t gauge_stats = { .prerendered = GAUGE_PRERENDERED };
+
+// Masks of the span being composited, the LVGL task draws one span at a time
+static lv_opa_t gauge_mask_out[GAUGE_MASK_SIZE];
+static lv_opa_t gauge_mask_in[GAUGE_MASK_SIZE];
+
+static uint16_t gauge_angle_span(uint16_t start, uint16_t end) {
+    int32_t span = (int32_t)end - start;
+    if (span < 0) {
+        span += 360;
+    }
+    return span;
+}
+
+static float gauge_clamp(float coverage) {
+    return coverage < 0.0f ? 0.0f : coverage > 1.0f ? 1.0f : coverage;
+}
+
+// Centre of the rounded end at `angle`, relative to the centre of the ring
+static void gauge_cap_center(const gauge_key_t *key, int32_t angle, float *x, float *y) {
+    float r = key->radius - key->width / 2.0f;
+    float a = angle * ((float)M_PI / 180.0f);
+    *x = r * cosf(a);
+    *y = r * sinf(a);
+}
+
+static float gauge_cap_coverage(const gauge_key_t *key, float cap_x, float cap_y, float x, float y) {
+    return gauge_clamp(key->width / 2.0f + 0.5f - hypotf(x - cap_x, y - cap_y));
+}
+
+// Coverage and angle of the pixel at (x, y) from the centre, the caps are the ends of the background arc
+static lv_opa_t gauge_pixel(const gauge_key_t *key, const float caps[4], int32_t x, int32_t y, uint16_t *angle) {
+    float d = sqrtf((float)(x * x + y * y));
+    float ring = LV_MIN(gauge_clamp(key->radius + 0.5f - d), gauge_clamp(d - (key->radius - key->width) + 0.5f));
+
+    *angle = GAUGE_ANGLE_NONE;
+    if (ring > 0.0f) {
+        float a = fmodf(atan2f((float)y, (float)x) * (180.0f / (float)M_PI) - key->start + 720.0f, 360.0f);
+        if (key->span >= 360 || a <= key->span) {
+            *angle = (uint16_t)(a * GAUGE_ANGLE_SCALE);
+        } else {
+            ring = 0.0f;
+        }
+    }
+    if (key->rounded && key->span < 360) {
+        ring = LV_MAX(ring, gauge_cap_coverage(key, caps[0], caps[1], x, y));
+        ring = LV_MAX(ring, gauge_cap_coverage(key, caps[2], caps[3], x, y));
+    }
+    return (lv_opa_t)(ring * LV_OPA_COVER + 0.5f);
+}
+
+// Rasterises a ring once: a first pass counts the covered spans and pixels, the second one fills them in
+static gauge_shape_t *gauge_shape_create(const gauge_key_t *key) {
+    lv_coord_t extent = key->radius + 1;
+    uint32_t rows = 2 * extent + 1;
+    if (rows > GAUGE_MASK_SIZE) {
+        return NULL;
+    }
+
+    float caps[4];
+    gauge_cap_center(key, key->start, &caps[0], &caps[1]);
+    gauge_cap_center(key, key->start + key->span, &caps[2], &caps[3]);
+
+    uint32_t spans = 0;
+    uint32_t pixels = 0;
+    uint16_t angle;
+    for (int32_t y = -extent; y <= extent; y++) {
+        bool covered = false;
+        for (int32_t x = -extent; x <= extent; x++) {
+            bool pixel = gauge_pixel(key, caps, x, y, &angle) > 0;
+            spans += pixel && !covered;
+            pixels += pixel;
+            covered = pixel;
+        }
+    }
+
+    uint32_t size = sizeof(gauge_shape_t) + spans * sizeof(gauge_span_t) + (rows + 1) * sizeof(uint16_t)
+                    + pixels * (sizeof(uint16_t) + sizeof(lv_opa_t));
+    gauge_shape_t *shape = lv_mem_alloc(size);
+    if (!shape) {
+        return NULL;
+    }
+    shape->key = *key;
+    shape->extent = extent;
+    shape->size = size;
+    shape->spans = (gauge_span_t *)(shape + 1);
+    shape->rows = (uint16_t *)(shape->spans + spans);
+    shape->angles = shape->rows + rows + 1;
+    shape->coverage = (lv_opa_t *)(shape->angles + pixels);
+
+    gauge_span_t *span = NULL;
+    uint32_t count = 0;
+    uint32_t offset = 0;
+    for (int32_t y = -extent; y <= extent; y++) {
+        shape->rows[y + extent] = count;
+        bool covered = false;
+        for (int32_t x = -extent; x <= extent; x++) {
+            lv_opa_t coverage = gauge_pixel(key, caps, x, y, &angle);
+            if (coverage == 0) {
+                covered = false;
+                continue;
+            }
+            if (!covered) {
+                span = &shape->spans[count++];
+                span->x = x;
+                span->len = 0;
+                span->offset = offset;
+            }
+            span->len++;
+            shape->angles[offset] = angle;
+            shape->coverage[offset] = coverage;
+            offset++;
+            covered = true;
+        }
+    }
+    shape->rows[rows] = count;
+
+    gauge_stats.shape_bytes += size;
+    return shape;
+}
+
+static void gauge_shape_release(gauge_shape_t *shape, const gauge_shape_t *other) {
+    if (shape && shape != other) {
+        gauge_stats.shape_bytes -= shape->size;
+        lv_mem_free(shape);
+    }
+}
+
+// Makes sure `part` has a ring rasterised for `key`, the indicator shares the background's when they match
+static bool gauge_part_prepare(gauge_t *gauge, gauge_part_t *part, const gauge_key_t *key) {
+    if (part->shape && memcmp(&part->shape->key, key, sizeof(*key)) == 0) {
+        return true;
+    }
+    gauge_part_t *other = part == &gauge->bg ? &gauge->indic : &gauge->bg;
+    gauge_shape_release(part->shape, other->shape);
+    if (other->shape && memcmp(&other->shape->key, key, sizeof(*key)) == 0) {
+        part->shape = other->shape;
+    } else {
+        part->shape = gauge_shape_create(key);
+    }
+    return part->shape != NULL;
+}
+
+// Invalidates a gauge from outside the refresh, LVGL ignores invalidations while rendering
+static void gauge_invalidate(void *obj) {
+    lv_obj_invalidate(obj);
+}
+
+// Takes over drawing of the background and indicator arcs, lv_draw_arc() returns right away for a transparent arc
+static void gauge_part_begin(lv_obj_t *obj, gauge_t *gauge, lv_obj_draw_part_dsc_t *dsc) {
+    if (gauge->failed || dsc->class_p != &lv_arc_class || !dsc->arc_dsc || dsc->arc_dsc->img_src) {
+        return;
+    }
+    gauge_part_t *part;
+    if (dsc->type == LV_ARC_DRAW_PART_BACKGROUND) {
+        part = &gauge->bg;
+    } else if (dsc->type == LV_ARC_DRAW_PART_FOREGROUND) {
+        part = &gauge->indic;
+    } else {
+        return;
+    }
+
+    const lv_arc_t *arc = (const lv_arc_t *)obj;
+    gauge_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.radius = dsc->radius;
+    key.width = LV_MIN(dsc->arc_dsc->width, dsc->radius);
+    key.start = (arc->bg_angle_start + arc->rotation) % 360;
+    key.span = gauge_angle_span(arc->bg_angle_start, arc->bg_angle_end);
+    key.rounded = dsc->arc_dsc->rounded;
+    if (key.span == 0 && arc->bg_angle_start != arc->bg_angle_end) {
+        key.span = 360;
+    }
+
+    if (!gauge_part_prepare(gauge, part, &key)) {
+        // The background composited later would cover the indicator lv_arc is about to draw. lv_draw_arc()
+        // already skipped it though, so the gauge is invalidated once the refresh is over to draw it in full
+        gauge->failed = true;
+        gauge->bg.drawn = false;
+        gauge_shape_release(gauge->indic.shape, gauge->bg.shape);
+        gauge_shape_release(gauge->bg.shape, NULL);
+        gauge->indic.shape = NULL;
+        gauge->bg.shape = NULL;
+        lv_async_call(gauge_invalidate, obj);
+        return;
+    }
+    part->center = *dsc->p1;
+    part->color = dsc->arc_dsc->color;
+    part->opa = dsc->arc_dsc->opa;
+    part->blend_mode = dsc->arc_dsc->blend_mode;
+    part->drawn = true;
+    dsc->arc_dsc->opa = LV_OPA_TRANSP;
+}
+
+static void gauge_blend(lv_draw_ctx_t *draw_ctx, const gauge_part_t *part, const lv_area_t *area, lv_opa_t *mask) {
+    lv_draw_sw_blend_dsc_t dsc;
+    lv_memset_00(&dsc, sizeof(dsc));
+    dsc.blend_area = area;
+    dsc.mask_area = area;
+    dsc.mask_buf = mask;
+    dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    dsc.color = part->color;
+    dsc.opa = part->opa;
+    dsc.blend_mode = part->blend_mode;
+    lv_draw_sw_blend(draw_ctx, &dsc);
+}
+
+// Composites the rows of a ring that fall in the clip area, with `inside` for the pixels whose angle is in
+// [start, end) and `outside` for the rest. Either part may be NULL to leave those pixels alone.
+static void gauge_draw_ring(lv_draw_ctx_t *draw_ctx, const gauge_shape_t *shape, const lv_point_t *center,
+                            const gauge_part_t *outside, const gauge_part_t *inside, uint16_t start, uint16_t end) {
+    const lv_area_t *clip = draw_ctx->clip_area;
+    int32_t y1 = LV_MAX(clip->y1, center->y - shape->extent);
+    int32_t y2 = LV_MIN(clip->y2, center->y + shape->extent);
+
+    for (int32_t y = y1; y <= y2; y++) {
+        int32_t row = y - (center->y - shape->extent);
+        for (uint32_t i = shape->rows[row]; i < shape->rows[row + 1]; i++) {
+            const gauge_span_t *span = &shape->spans[i];
+            lv_area_t area = { center->x + span->x, y, center->x + span->x + span->len - 1, y };
+            uint32_t first = 0;
+            if (area.x1 < clip->x1) {
+                first = clip->x1 - area.x1;
+                area.x1 = clip->x1;
+            }
+            area.x2 = LV_MIN(area.x2, clip->x2);
+            if (area.x1 > area.x2) {
+                continue;
+            }
+
+            const uint16_t *angles = shape->angles + span->offset + first;
+            const lv_opa_t *coverage = shape->coverage + span->offset + first;
+            int32_t len = lv_area_get_width(&area);
+            bool any_out = false;
+            bool any_in = false;
+            for (int32_t x = 0; x < len; x++) {
+                bool in = angles[x] >= start && angles[x] < end;
+                gauge_mask_out[x] = in ? 0 : coverage[x];
+                gauge_mask_in[x] = in ? coverage[x] : 0;
+                any_out |= !in;
+                any_in |= in;
+            }
+            if (outside && any_out) {
+                gauge_blend(draw_ctx, outside, &area, gauge_mask_out);
+            }
+            if (inside && any_in) {
+                gauge_blend(draw_ctx, inside, &area, gauge_mask_in);
+            }
+        }
+    }
+}
+
+// Rounded end of the indicator, only a width x width square so it's rasterised as it's drawn
+static void gauge_draw_cap(lv_draw_ctx_t *draw_ctx, const gauge_part_t *part, int32_t angle) {
+    const gauge_key_t *key = &part->shape->key;
+    float cap_x, cap_y;
+    gauge_cap_center(key, angle, &cap_x, &cap_y);
+
+    lv_area_t cap = {
+        part->center.x + (lv_coord_t)floorf(cap_x - key->width / 2.0f),
+        part->center.y + (lv_coord_t)floorf(cap_y - key->width / 2.0f),
+        part->center.x + (lv_coord_t)ceilf(cap_x + key->width / 2.0f),
+        part->center.y + (lv_coord_t)ceilf(cap_y + key->width / 2.0f),
+    };
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, &cap, draw_ctx->clip_area)) {
+        return;
+    }
+
+    for (int32_t y = area.y1; y <= area.y2; y++) {
+        lv_area_t row = { area.x1, y, area.x2, y };
+        for (int32_t x = area.x1; x <= area.x2; x++) {
+            float coverage = gauge_cap_coverage(key, cap_x, cap_y, x - part->center.x, y - part->center.y);
+            gauge_mask_in[x - area.x1] = (lv_opa_t)(coverage * LV_OPA_COVER + 0.5f);
+        }
+        gauge_blend(draw_ctx, part, &row, gauge_mask_in);
+    }
+}
+
+static void gauge_draw(lv_obj_t *obj, gauge_t *gauge, lv_draw_ctx_t *draw_ctx) {
+    const lv_arc_t *arc = (const lv_arc_t *)obj;
+    const gauge_part_t *bg = gauge->bg.drawn && gauge->bg.opa > LV_OPA_MIN ? &gauge->bg : NULL;
+    const gauge_part_t *indic = gauge->indic.drawn && gauge->indic.opa > LV_OPA_MIN ? &gauge->indic : NULL;
+
+    // Indicator range from the start of the background arc
+    uint16_t span = gauge_angle_span(arc->indic_angle_start, arc->indic_angle_end);
+    if (span == 0 && arc->indic_angle_start != arc->indic_angle_end) {
+        span = 360;
+    }
+    if (span == 0) {
+        indic = NULL;
+    }
+    uint16_t offset = gauge_angle_span(arc->bg_angle_start, arc->indic_angle_start);
+    uint16_t start = offset * GAUGE_ANGLE_SCALE;
+    uint16_t end = (offset + span) * GAUGE_ANGLE_SCALE;
+
+    if (bg && indic && bg->shape == indic->shape && indic->opa >= LV_OPA_MAX) {
+        // An opaque indicator on the same ring hides the background, so each pixel is blended once
+        gauge_draw_ring(draw_ctx, bg->shape, &bg->center, bg, indic, start, end);
+    } else {
+        if (bg) {
+            gauge_draw_ring(draw_ctx, bg->shape, &bg->center, bg, NULL, 0, 0);
+        }
+        if (indic) {
+            gauge_draw_ring(draw_ctx, indic->shape, &indic->center, NULL, indic, start, end);
+        }
+    }
+
+    if (indic && indic->shape->key.rounded && span < 360) {
+        gauge_draw_cap(draw_ctx, indic, arc->indic_angle_start + arc->rotation);
+        gauge_draw_cap(draw_ctx, indic, arc->indic_angle_end + arc->rotation);
+    }
+}
+
+static void gauge_stats_record(int64_t us) {
+    gauge_stats.draws++;
+    gauge_stats.draw_us += us;
+    gauge_stats.max_draw_us = LV_MAX(gauge_stats.max_draw_us, (uint32_t)us);
+}
+
+static void gauge_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *obj = lv_event_get_target(e);
+    gauge_t *gauge = lv_event_get_user_data(e);
+
+    switch (code) {
+    case LV_EVENT_DRAW_MAIN_BEGIN:
+        gauge->bg.drawn = false;
+        gauge->indic.drawn = false;
+        gauge->draw_start = esp_timer_get_time();
+        if (lv_arc_get_value(obj) != gauge->drawn_value) {
+            gauge->drawn_value = lv_arc_get_value(obj);
+            gauge_stats.changes++;
+        }
+        break;
+    case LV_EVENT_DRAW_PART_BEGIN:
+        if (GAUGE_PRERENDERED) {
+            gauge_part_begin(obj, gauge, lv_event_get_draw_part_dsc(e));
+        }
+        break;
+    case LV_EVENT_DRAW_MAIN:
+        // Sent to the event callbacks after lv_arc has drawn the parts it wasn't relieved of
+        gauge_draw(obj, gauge, lv_event_get_draw_ctx(e));
+        break;
+    case LV_EVENT_DRAW_MAIN_END:
+        gauge_stats_record(esp_timer_get_time() - gauge->draw_start);
+        break;
+    case LV_EVENT_DELETE:
+        lv_async_call_cancel(gauge_invalidate, obj);
+        gauge_shape_release(gauge->indic.shape, gauge->bg.shape);
+        gauge_shape_release(gauge->bg.shape, NULL);
+        lv_mem_free(gauge);
+        break;
+    default:
+        break;
+    }
+}
+
+void gauge_attach(lv_obj_t *arc) {
+    gauge_t *gauge = lv_mem_alloc(sizeof(gauge_t));
+    LV_ASSERT_MALLOC(gauge);
+    if (!gauge) {
+        return;
+    }
+    lv_memset_00(gauge, sizeof(gauge_t));
+    gauge->drawn_value = lv_arc_get_value(arc);
+    lv_obj_add_event_cb(arc, gauge_event_cb, LV_EVENT_ALL, gauge);
+}
+
+void gauge_get_stats(gauge_stats_t *stats) {
+    // Written by the LVGL task, the fields may be a draw apart
+    *stats = gauge_stats;
+}
@@ -0,0 +1,44 @@
+#ifndef EEZ_LVGL_UI_GAUGE_H
+#define EEZ_LVGL_UI_GAUGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <lvgl.h>
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gauges are lv_arc objects whose rings are composited from coverage and angle maps rasterised once,
+// instead of being drawn with anti-aliased radius and angle masks by lv_draw_arc() on every refresh.
+// The arc keeps its value, range, styles and invalidation, so EEZ flow bindings work unchanged.
+#ifdef CONFIG_UI_GAUGE_PRERENDERED
+#define GAUGE_PRERENDERED (1)
+#else
+#define GAUGE_PRERENDERED (0)
+#endif
+
+#define GAUGE_SIZE_MAX (480) // Largest gauge diameter that is pre-rendered, larger arcs are drawn by lv_arc
+
+// Draw time of the gauges, to compare the pre-rendered gauges with lv_arc
+typedef struct {
+    bool prerendered;       // Whether the gauges are composited from pre-rendered masks or drawn by lv_arc
+    uint32_t draws;         // Gauge draws since start-up, one per invalidated area a gauge is in
+    uint32_t changes;       // Draws of a value the gauge hadn't drawn before
+    uint32_t draw_us;       // Total time spent drawing gauges, their background included
+    uint32_t max_draw_us;   // Longest gauge draw
+    uint32_t shape_bytes;   // Memory held by the pre-rendered masks
+} gauge_stats_t;
+
+// Turns an lv_arc into a gauge, call once after creating it
+void gauge_attach(lv_obj_t *arc);
+void gauge_get_stats(gauge_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*EEZ_LVGL_UI_GAUGE_H*/
@@ -1,3 +1,4 @@
+#include <assert.h>
 #include <string.h>
 
 #include "screens.h"
@@ -7,12 +8,37 @@
 #include "vars.h"
 #include "styles.h"
 #include "ui.h"
+#include "digit_atlas.h"
+#include "gauge.h"
+#include "static_layer.h"
 
 #include <string.h>
 
 objects_t objects;
 lv_obj_t *tick_value_change_obj;
 
+// Set to evaluate every property of the main screen on its next tick
+static bool tick_screen_main_all;
+// Static layers of the inverter and solar containers of the main screen
+static static_layer_t *tick_screen_main_layers[2];
+
+// Widgets of the main screen tick_screen_main() sets or the flow's LVGL actions change, everything else
+// (the icons included, though they're named in `objects`) is static
+static bool tick_obj_is_bound(lv_obj_t *obj) {
+    lv_obj_t *const bound[] = {
+        objects.obj0, objects.obj3, objects.ac_watts_arc, objects.obj4, objects.inv_error,
+        objects.soc, objects.obj5, objects.batt_alarm, objects.obj6, objects.obj7, objects.obj8,
+        objects.obj9, objects.pv_power, objects.obj10, objects.yield, objects.obj11, objects.solar_error,
+        objects.batt_indicator_image, objects.soc_container, objects.soc_unknown_container,
+    };
+    for (size_t i = 0; i < sizeof(bound) / sizeof(bound[0]); i++) {
+        if (bound[i] == obj) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void event_handler_cb_main_obj0(lv_event_t *e) {
     lv_event_code_t event = lv_event_get_code(e);
     void *flowState = lv_event_get_user_data(e);
@@ -194,6 +220,7 @@ void create_screen_main() {
                     lv_obj_add_event_cb(obj, event_handler_cb_main_ac_watts_arc, LV_EVENT_ALL, flowState);
                     lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
                     add_style_arcs(obj);
+                    gauge_attach(obj);
                     {
                         lv_obj_t *parent_obj = obj;
                         {
@@ -221,6 +248,7 @@ void create_screen_main() {
                                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                                     add_style_labels(obj);
                                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                                    digit_atlas_attach(obj);
                                     lv_label_set_text(obj, "");
                                 }
                                 {
@@ -293,6 +321,7 @@ void create_screen_main() {
                     lv_obj_add_event_cb(obj, event_handler_cb_main_soc, LV_EVENT_ALL, flowState);
                     lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
                     add_style_arcs(obj);
+                    gauge_attach(obj);
                     {
                         lv_obj_t *parent_obj = obj;
                         {
@@ -374,6 +403,7 @@ void create_screen_main() {
                                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                                     add_style_labels(obj);
                                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                                    digit_atlas_attach(obj);
                                     lv_label_set_text(obj, "~");
                                 }
                             }
@@ -404,6 +434,7 @@ void create_screen_main() {
                                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                                     add_style_labels(obj);
                                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                                    digit_atlas_attach(obj);
                                     lv_label_set_text(obj, "");
                                 }
                                 {
@@ -570,6 +601,7 @@ void create_screen_main() {
                     lv_obj_add_event_cb(obj, event_handler_cb_main_pv_power, LV_EVENT_ALL, flowState);
                     lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
                     add_style_arcs(obj);
+                    gauge_attach(obj);
                 }
                 {
                     lv_obj_t *obj = lv_obj_create(parent_obj);
@@ -619,6 +651,7 @@ void create_screen_main() {
                                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                                     add_style_labels(obj);
                                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                                    digit_atlas_attach(obj);
                                     lv_label_set_text(obj, "");
                                 }
                                 {
@@ -648,6 +681,7 @@ void create_screen_main() {
                     lv_obj_add_event_cb(obj, event_handler_cb_main_yield, LV_EVENT_ALL, flowState);
                     lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
                     add_style_arcs(obj);
+                    gauge_attach(obj);
                 }
                 {
                     lv_obj_t *obj = lv_obj_create(parent_obj);
@@ -697,6 +731,7 @@ void create_screen_main() {
                                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                                     add_style_labels(obj);
                                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                                    digit_atlas_attach(obj);
                                     lv_label_set_text(obj, "");
                                 }
                                 {
@@ -742,11 +777,16 @@ void create_screen_main() {
         }
     }
     
+    tick_screen_main_layers[0] = static_layer_create(objects.inverter_container, tick_obj_is_bound);
+    tick_screen_main_layers[1] = static_layer_create(objects.solar_container, tick_obj_is_bound);
+    tick_screen_main_all = true;
     tick_screen_main();
 }
 
 void delete_screen_main() {
     lv_obj_del(objects.main);
+    tick_screen_main_layers[0] = NULL;
+    tick_screen_main_layers[1] = NULL;
     objects.main = 0;
     objects.inverter_container = 0;
     objects.obj0 = 0;
@@ -778,163 +818,354 @@ void delete_screen_main() {
     deletePageFlowState(0);
 }
 
+// Label texts set by the ticks live in these fixed buffers instead of the LVGL heap
+#define TICK_LABEL_TEXT_SIZE 64
+
+typedef struct {
+    char text[2][TICK_LABEL_TEXT_SIZE];
+    uint8_t current;
+} tick_label_text_t;
+
+// With CONFIG_UI_TICK_CHECK, the properties of the main screen a tick would skip because their native variable
+// didn't change are evaluated anyway, as a dry run that only compares the value with the widget
+#ifdef CONFIG_UI_TICK_CHECK
+#define TICK_CHECK (1)
+#else
+#define TICK_CHECK (0)
+#endif
+
+// Version slot of the property being dry run, or -1
+static int tick_check_slot = -1;
+static void tick_check_mismatch(void);
+
+// Returns true if the property whose value changed is only dry run, after reporting the mismatch
+static bool tick_check_changed(void) {
+    if (!TICK_CHECK || tick_check_slot < 0) {
+        return false;
+    }
+    tick_check_mismatch();
+    return true;
+}
+
+// Sets the text of a label without allocating, flipping to the buffer LVGL isn't showing
+static void tick_label_set_text(lv_obj_t *label, tick_label_text_t *buffers, const char *text) {
+    if (tick_check_changed()) {
+        return;
+    }
+    size_t len = strlen(text);
+    if (len >= TICK_LABEL_TEXT_SIZE) {
+        // Rare long texts (error messages) still go through the heap rather than being truncated
+        lv_label_set_text(label, text);
+        return;
+    }
+    buffers->current ^= 1;
+    memcpy(buffers->text[buffers->current], text, len + 1);
+    lv_label_set_text_static(label, buffers->text[buffers->current]);
+}
+
+// Update policy of an arc set by a tick, keeps small fluctuations from redrawing the arc
+typedef struct {
+    int32_t deadband;           // Smallest change that's drawn right away, except to reach either end of the range
+    uint32_t min_interval_ms;   // Minimum time between two redraws, and how long a value must hold to be drawn anyway
+    uint32_t last_update_ms;
+    int32_t drawn_val;          // Value the arc was last set to
+    int32_t target_val;         // Value last evaluated
+    uint32_t target_ms;         // When target_val was first evaluated
+    bool pending;               // target_val still has to be drawn
+} tick_arc_t;
+
+// Set while an arc holds back a value, so the UI keeps ticking until it's drawn
+static bool tick_arcs_pending;
+
+// Indicator angle of `value`, relative to the start of the background arc
+static int32_t tick_arc_angle(lv_obj_t *arc, int32_t value) {
+    int32_t span = lv_arc_get_bg_angle_end(arc) - lv_arc_get_bg_angle_start(arc);
+    if (span <= 0) {
+        span += 360;
+    }
+    return lv_map(value, lv_arc_get_min_value(arc), lv_arc_get_max_value(arc), 0, span);
+}
+
+// Notes the value an arc's property evaluated to
+static void tick_arc_eval(tick_arc_t *policy, int32_t new_val, bool all) {
+    if (TICK_CHECK && tick_check_slot >= 0) {
+        if (new_val != policy->target_val) {
+            tick_check_mismatch();
+        }
+        return;
+    }
+    if (new_val != policy->target_val) {
+        policy->target_val = new_val;
+        policy->target_ms = lv_tick_get();
+    }
+    policy->pending = all || new_val != policy->drawn_val;
+}
+
+// Returns true if the pending value may be drawn now
+static bool tick_arc_due(lv_obj_t *arc, const tick_arc_t *policy) {
+    if (lv_tick_elaps(policy->last_update_ms) < policy->min_interval_ms) {
+        return false;
+    }
+    // A value that held for the minimum interval is the final one, it's drawn whatever the change
+    if (lv_tick_elaps(policy->target_ms) >= policy->min_interval_ms) {
+        return true;
+    }
+    int32_t new_val = policy->target_val;
+    bool at_end = new_val <= lv_arc_get_min_value(arc) || new_val >= lv_arc_get_max_value(arc);
+    if (!at_end && LV_ABS(new_val - policy->drawn_val) < policy->deadband) {
+        return false;
+    }
+    // Angles are whole degrees, a change that doesn't move the indicator would only invalidate the knob.
+    // When it does move, lv_arc only invalidates the sector between the old and new angle.
+    return tick_arc_angle(arc, new_val) != tick_arc_angle(arc, policy->drawn_val);
+}
+
+// Returns true if the arc should be set to `policy->target_val`. A value held back is kept pending and
+// checked again on the next ticks, until it's drawn or replaced by a newer one.
+static bool tick_arc_update(lv_obj_t *arc, tick_arc_t *policy, bool all) {
+    if (!policy->pending) {
+        return false;
+    }
+    if (!all && !tick_arc_due(arc, policy)) {
+        __atomic_store_n(&tick_arcs_pending, true, __ATOMIC_RELAXED);
+        return false;
+    }
+    policy->pending = false;
+    policy->drawn_val = policy->target_val;
+    policy->last_update_ms = lv_tick_get();
+    return true;
+}
+
+// Properties of the main screen that tick_screen_main() evaluates: the checked state of the inverter switch,
+// the value of each arc and the text of each label. The map from each property to the native variable it reads
+// is edited by hand, it has to follow vicmon.eez-project when the screen is regenerated. CONFIG_UI_TICK_CHECK
+// asserts that it does.
+#define TICK_SCREEN_MAIN_SWITCHES 1
+#define TICK_SCREEN_MAIN_ARCS 4
+#define TICK_SCREEN_MAIN_LABELS 12
+#define TICK_SCREEN_MAIN_PROPERTIES 17
+
+_Static_assert(TICK_SCREEN_MAIN_PROPERTIES == TICK_SCREEN_MAIN_SWITCHES + TICK_SCREEN_MAIN_ARCS + TICK_SCREEN_MAIN_LABELS,
+               "every property of the main screen needs a version slot");
+
+// Update policies of the arcs of the main screen
+static tick_arc_t tick_screen_main_arcs[TICK_SCREEN_MAIN_ARCS] = {
+    { .deadband = 10, .min_interval_ms = 250 },    // ac_watts_arc, 0 - 1500 W
+    { .deadband = 1, .min_interval_ms = 1000 },    // soc, 0 - 100 %
+    { .deadband = 4, .min_interval_ms = 250 },     // pv_power, 0 - 400 W
+    { .deadband = 10, .min_interval_ms = 1000 },   // yield, 0 - 850 Wh
+};
+
+// Text buffers of the labels set by tick_screen_main()
+static tick_label_text_t tick_screen_main_labels[TICK_SCREEN_MAIN_LABELS];
+// Version of the native variable each property of the main screen was last evaluated at, indexed in the
+// order tick_screen_main() evaluates them
+static uint32_t tick_screen_main_versions[TICK_SCREEN_MAIN_PROPERTIES];
+// Last value each label of the main screen was formatted from
+static eez_text_cache_t tick_screen_main_texts[TICK_SCREEN_MAIN_LABELS];
+
+#if TICK_CHECK
+// Ticks of the main screen, and the tick each property last differed from its widget at
+static uint32_t tick_check_ticks = 1;
+static uint32_t tick_check_missed[TICK_SCREEN_MAIN_PROPERTIES];
+#endif
+
+// Reports that the property being dry run differs from its widget, which means it reads a native variable
+// its version slot isn't mapped to
+static void tick_check_mismatch(void) {
+#if TICK_CHECK
+    // A write the snapshot doesn't have yet, or a switch the user just toggled, only differs for a tick
+    if (native_vars_pending()) {
+        return;
+    }
+    if (tick_check_missed[tick_check_slot] == tick_check_ticks - 1) {
+        LV_LOG_ERROR("property %d of the main screen reads a variable it isn't mapped to", tick_check_slot);
+        assert(!"main screen property map out of date");
+    }
+    tick_check_missed[tick_check_slot] = tick_check_ticks;
+#endif
+}
+
+// Returns true if `var` changed since `*version` or `all` is set, and updates `*version`. With TICK_CHECK an
+// unchanged variable returns true too, for a dry run of the property.
+static bool tick_var_changed(uint32_t *version, enum NativeVariables var, bool all) {
+    uint32_t new_version = native_var_version(var);
+    tick_check_slot = -1;
+    if (*version == new_version && !all) {
+        if (TICK_CHECK) {
+            tick_check_slot = version - tick_screen_main_versions;
+            return true;
+        }
+        return false;
+    }
+    *version = new_version;
+    return true;
+}
+
 void tick_screen_main() {
     void *flowState = getFlowState(0, 0);
     (void)flowState;
-    {
+    bool all = tick_screen_main_all;
+    tick_screen_main_all = false;
+    if (all) {
+        memset(tick_screen_main_texts, 0, sizeof(tick_screen_main_texts));
+    }
+    if (tick_var_changed(&tick_screen_main_versions[0], NATIVE_VAR_INV_SWITCH, all)) {
         bool new_val = evalBooleanProperty(flowState, 3, 3, "Failed to evaluate Checked state");
         bool cur_val = lv_obj_has_state(objects.obj0, LV_STATE_CHECKED);
-        if (new_val != cur_val) {
+        if (new_val != cur_val && !tick_check_changed()) {
             tick_value_change_obj = objects.obj0;
             if (new_val) lv_obj_add_state(objects.obj0, LV_STATE_CHECKED);
             else lv_obj_clear_state(objects.obj0, LV_STATE_CHECKED);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 4, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj3);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[1], NATIVE_VAR_INV_MODE, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 4, 3, &tick_screen_main_texts[0], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj3) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj3;
-            lv_label_set_text(objects.obj3, new_val);
+            tick_label_set_text(objects.obj3, &tick_screen_main_labels[0], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        int32_t new_val = evalIntegerProperty(flowState, 5, 3, "Failed to evaluate Value in Arc widget");
-        int32_t cur_val = lv_arc_get_value(objects.ac_watts_arc);
-        if (new_val != cur_val) {
-            tick_value_change_obj = objects.ac_watts_arc;
-            lv_arc_set_value(objects.ac_watts_arc, new_val);
-            tick_value_change_obj = NULL;
-        }
+    if (tick_var_changed(&tick_screen_main_versions[2], NATIVE_VAR_AC_WATTS, all)) {
+        tick_arc_eval(&tick_screen_main_arcs[0], evalIntegerProperty(flowState, 5, 3, "Failed to evaluate Value in Arc widget"), all);
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 7, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj4);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_arc_update(objects.ac_watts_arc, &tick_screen_main_arcs[0], all)) {
+        tick_value_change_obj = objects.ac_watts_arc;
+        lv_arc_set_value(objects.ac_watts_arc, tick_screen_main_arcs[0].target_val);
+        tick_value_change_obj = NULL;
+    }
+    if (tick_var_changed(&tick_screen_main_versions[3], NATIVE_VAR_AC_WATTS, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 7, 3, &tick_screen_main_texts[1], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj4) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj4;
-            lv_label_set_text(objects.obj4, new_val);
+            tick_label_set_text(objects.obj4, &tick_screen_main_labels[1], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 10, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.inv_error);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[4], NATIVE_VAR_INV_ERROR, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 10, 3, &tick_screen_main_texts[2], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.inv_error) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.inv_error;
-            lv_label_set_text(objects.inv_error, new_val);
+            tick_label_set_text(objects.inv_error, &tick_screen_main_labels[2], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        int32_t new_val = evalIntegerProperty(flowState, 13, 3, "Failed to evaluate Value in Arc widget");
-        int32_t cur_val = lv_arc_get_value(objects.soc);
-        if (new_val != cur_val) {
-            tick_value_change_obj = objects.soc;
-            lv_arc_set_value(objects.soc, new_val);
-            tick_value_change_obj = NULL;
-        }
+    if (tick_var_changed(&tick_screen_main_versions[5], NATIVE_VAR_BATT_SOC, all)) {
+        tick_arc_eval(&tick_screen_main_arcs[1], evalIntegerProperty(flowState, 13, 3, "Failed to evaluate Value in Arc widget"), all);
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 14, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj5);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_arc_update(objects.soc, &tick_screen_main_arcs[1], all)) {
+        tick_value_change_obj = objects.soc;
+        lv_arc_set_value(objects.soc, tick_screen_main_arcs[1].target_val);
+        tick_value_change_obj = NULL;
+    }
+    if (tick_var_changed(&tick_screen_main_versions[6], NATIVE_VAR_SOLAR_MODE, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 14, 3, &tick_screen_main_texts[3], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj5) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj5;
-            lv_label_set_text(objects.obj5, new_val);
+            tick_label_set_text(objects.obj5, &tick_screen_main_labels[3], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 18, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.batt_alarm);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[7], NATIVE_VAR_BATT_ALARM, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 18, 3, &tick_screen_main_texts[4], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.batt_alarm) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.batt_alarm;
-            lv_label_set_text(objects.batt_alarm, new_val);
+            tick_label_set_text(objects.batt_alarm, &tick_screen_main_labels[4], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 22, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj6);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[8], NATIVE_VAR_BATT_SOC, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 22, 3, &tick_screen_main_texts[5], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj6) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj6;
-            lv_label_set_text(objects.obj6, new_val);
+            tick_label_set_text(objects.obj6, &tick_screen_main_labels[5], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 26, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj7);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[9], NATIVE_VAR_BATT_VOLT, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 26, 3, &tick_screen_main_texts[6], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj7) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj7;
-            lv_label_set_text(objects.obj7, new_val);
+            tick_label_set_text(objects.obj7, &tick_screen_main_labels[6], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 29, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj8);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[10], NATIVE_VAR_BATT_AMP, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 29, 3, &tick_screen_main_texts[7], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj8) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj8;
-            lv_label_set_text(objects.obj8, new_val);
+            tick_label_set_text(objects.obj8, &tick_screen_main_labels[7], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 34, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj9);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[11], NATIVE_VAR_BATT_TEMP, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 34, 3, &tick_screen_main_texts[8], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj9) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj9;
-            lv_label_set_text(objects.obj9, new_val);
+            tick_label_set_text(objects.obj9, &tick_screen_main_labels[8], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        int32_t new_val = evalIntegerProperty(flowState, 35, 3, "Failed to evaluate Value in Arc widget");
-        int32_t cur_val = lv_arc_get_value(objects.pv_power);
-        if (new_val != cur_val) {
-            tick_value_change_obj = objects.pv_power;
-            lv_arc_set_value(objects.pv_power, new_val);
-            tick_value_change_obj = NULL;
-        }
+    if (tick_var_changed(&tick_screen_main_versions[12], NATIVE_VAR_SOLAR_WATTS, all)) {
+        tick_arc_eval(&tick_screen_main_arcs[2], evalIntegerProperty(flowState, 35, 3, "Failed to evaluate Value in Arc widget"), all);
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 39, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj10);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_arc_update(objects.pv_power, &tick_screen_main_arcs[2], all)) {
+        tick_value_change_obj = objects.pv_power;
+        lv_arc_set_value(objects.pv_power, tick_screen_main_arcs[2].target_val);
+        tick_value_change_obj = NULL;
+    }
+    if (tick_var_changed(&tick_screen_main_versions[13], NATIVE_VAR_SOLAR_WATTS, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 39, 3, &tick_screen_main_texts[9], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj10) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj10;
-            lv_label_set_text(objects.obj10, new_val);
+            tick_label_set_text(objects.obj10, &tick_screen_main_labels[9], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        int32_t new_val = evalIntegerProperty(flowState, 41, 3, "Failed to evaluate Value in Arc widget");
-        int32_t cur_val = lv_arc_get_value(objects.yield);
-        if (new_val != cur_val) {
-            tick_value_change_obj = objects.yield;
-            lv_arc_set_value(objects.yield, new_val);
-            tick_value_change_obj = NULL;
-        }
+    if (tick_var_changed(&tick_screen_main_versions[14], NATIVE_VAR_SOLAR_YIELD, all)) {
+        tick_arc_eval(&tick_screen_main_arcs[3], evalIntegerProperty(flowState, 41, 3, "Failed to evaluate Value in Arc widget"), all);
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 45, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.obj11);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_arc_update(objects.yield, &tick_screen_main_arcs[3], all)) {
+        tick_value_change_obj = objects.yield;
+        lv_arc_set_value(objects.yield, tick_screen_main_arcs[3].target_val);
+        tick_value_change_obj = NULL;
+    }
+    if (tick_var_changed(&tick_screen_main_versions[15], NATIVE_VAR_SOLAR_YIELD, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 45, 3, &tick_screen_main_texts[10], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.obj11) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj11;
-            lv_label_set_text(objects.obj11, new_val);
+            tick_label_set_text(objects.obj11, &tick_screen_main_labels[10], new_val);
             tick_value_change_obj = NULL;
         }
     }
-    {
-        const char *new_val = evalTextProperty(flowState, 47, 3, "Failed to evaluate Text in Label widget");
-        const char *cur_val = lv_label_get_text(objects.solar_error);
-        if (strcmp(new_val, cur_val) != 0) {
+    if (tick_var_changed(&tick_screen_main_versions[16], NATIVE_VAR_SOLAR_ERROR, all)) {
+        const char *new_val = evalTextPropertyCached(flowState, 47, 3, &tick_screen_main_texts[11], "Failed to evaluate Text in Label widget");
+        const char *cur_val = new_val ? lv_label_get_text(objects.solar_error) : NULL;
+        if (new_val && strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.solar_error;
-            lv_label_set_text(objects.solar_error, new_val);
+            tick_label_set_text(objects.solar_error, &tick_screen_main_labels[11], new_val);
             tick_value_change_obj = NULL;
         }
     }
+    tick_check_slot = -1;
+#if TICK_CHECK
+    tick_check_ticks++;
+#endif
+    static_layer_update(tick_screen_main_layers[0]);
+    static_layer_update(tick_screen_main_layers[1]);
 }
 
 void create_screen_config() {
@@ -1036,6 +1267,7 @@ void create_screen_config() {
                     lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
                     lv_obj_set_style_align(obj, LV_ALIGN_TOP_MID, LV_PART_MAIN | LV_STATE_DEFAULT);
                     lv_obj_set_style_text_font(obj, &ui_font_roboto_med_48, LV_PART_MAIN | LV_STATE_DEFAULT);
+                    digit_atlas_attach(obj);
                     lv_label_set_text(obj, "");
                 }
                 {
@@ -1270,6 +1502,9 @@ void delete_screen_config() {
     deletePageFlowState(1);
 }
 
+// Text buffers of the labels set by tick_screen_config()
+static tick_label_text_t tick_screen_config_labels[10];
+
 void tick_screen_config() {
     void *flowState = getFlowState(0, 1);
     (void)flowState;
@@ -1288,7 +1523,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj13);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj13;
-            lv_label_set_text(objects.obj13, new_val);
+            tick_label_set_text(objects.obj13, &tick_screen_config_labels[0], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1297,7 +1532,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj14);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj14;
-            lv_label_set_text(objects.obj14, new_val);
+            tick_label_set_text(objects.obj14, &tick_screen_config_labels[1], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1306,7 +1541,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj15);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj15;
-            lv_label_set_text(objects.obj15, new_val);
+            tick_label_set_text(objects.obj15, &tick_screen_config_labels[2], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1324,7 +1559,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj16);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj16;
-            lv_label_set_text(objects.obj16, new_val);
+            tick_label_set_text(objects.obj16, &tick_screen_config_labels[3], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1333,7 +1568,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj17);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj17;
-            lv_label_set_text(objects.obj17, new_val);
+            tick_label_set_text(objects.obj17, &tick_screen_config_labels[4], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1342,7 +1577,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj18);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj18;
-            lv_label_set_text(objects.obj18, new_val);
+            tick_label_set_text(objects.obj18, &tick_screen_config_labels[5], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1351,7 +1586,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj19);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj19;
-            lv_label_set_text(objects.obj19, new_val);
+            tick_label_set_text(objects.obj19, &tick_screen_config_labels[6], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1360,7 +1595,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj20);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj20;
-            lv_label_set_text(objects.obj20, new_val);
+            tick_label_set_text(objects.obj20, &tick_screen_config_labels[7], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1369,7 +1604,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj21);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj21;
-            lv_label_set_text(objects.obj21, new_val);
+            tick_label_set_text(objects.obj21, &tick_screen_config_labels[8], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1378,7 +1613,7 @@ void tick_screen_config() {
         const char *cur_val = lv_label_get_text(objects.obj22);
         if (strcmp(new_val, cur_val) != 0) {
             tick_value_change_obj = objects.obj22;
-            lv_label_set_text(objects.obj22, new_val);
+            tick_label_set_text(objects.obj22, &tick_screen_config_labels[9], new_val);
             tick_value_change_obj = NULL;
         }
     }
@@ -1442,11 +1677,16 @@ tick_screen_func_t tick_screen_funcs[] = {
     tick_screen_config,
 };
 void tick_screen(int screen_index) {
+    __atomic_store_n(&tick_arcs_pending, false, __ATOMIC_RELAXED);
     tick_screen_funcs[screen_index]();
 }
 void tick_screen_by_id(enum ScreensEnum screenId) {
+    __atomic_store_n(&tick_arcs_pending, false, __ATOMIC_RELAXED);
     tick_screen_funcs[screenId - 1]();
 }
+bool tick_screen_pending() {
+    return __atomic_load_n(&tick_arcs_pending, __ATOMIC_RELAXED);
+}
 
 void create_screens() {
     eez_flow_init_styles(add_style, remove_style);
@@ -81,6 +81,8 @@ void create_screen_by_id(enum ScreensEnum screenId);
 void delete_screen_by_id(enum ScreensEnum screenId);
 void tick_screen_by_id(enum ScreensEnum screenId);
 void tick_screen(int screen_index);
+// Whether the last tick held back a value that a later tick still has to draw
+bool tick_screen_pending();
 
 void create_screens();
 
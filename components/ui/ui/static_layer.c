@@ -0,0 +1,231 @@
+#include <string.h>
+
+#include "static_layer.h"
+
+#define STATIC_LAYER_PX_SIZE LV_IMG_PX_SIZE_ALPHA_BYTE // Bytes of an LV_IMG_CF_TRUE_COLOR_ALPHA pixel
+
+// A static widget and where it was last flattened
+typedef struct {
+    lv_obj_t *obj;
+    lv_area_t area;     // Coordinates, extended by the draw size outside of them (e.g. shadows)
+    bool visible;       // No ancestor up to the container is hidden
+} static_layer_widget_t;
+
+struct _static_layer_t {
+    lv_obj_t *container;
+    static_layer_widget_t *widgets;
+    uint32_t count;
+    bool valid;         // The snapshot matches the widgets
+    lv_area_t area;     // Covered by the snapshot, the union of the visible static widgets
+    lv_img_dsc_t img;   // LV_IMG_CF_TRUE_COLOR_ALPHA, no data if no static widget is visible
+};
+
+static static_layer_stats_t static_layer_stats;
+
+static uint32_t static_layer_collect(lv_obj_t *obj, static_layer_bound_cb_t is_bound, static_layer_widget_t *widgets) {
+    uint32_t count = 0;
+    uint32_t children = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        lv_obj_t *child = lv_obj_get_child(obj, i);
+        if (lv_obj_get_child_cnt(child) > 0) {
+            count += static_layer_collect(child, is_bound, widgets ? widgets + count : NULL);
+        } else if (!is_bound(child) && !lv_obj_has_flag_any(child, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_HIDDEN) &&
+                   lv_obj_get_style_layout(obj, LV_PART_MAIN) == 0) {
+            if (widgets) {
+                widgets[count].obj = child;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+static void static_layer_widget_area(const lv_obj_t *obj, lv_area_t *area) {
+    lv_coord_t ext = _lv_obj_get_ext_draw_size(obj);
+    lv_obj_get_coords(obj, area);
+    lv_area_increase(area, ext, ext);
+}
+
+static bool static_layer_widget_visible(const static_layer_t *layer, const lv_obj_t *obj) {
+    for (const lv_obj_t *parent = lv_obj_get_parent(obj); parent != layer->container; parent = lv_obj_get_parent(parent)) {
+        if (lv_obj_has_flag(parent, LV_OBJ_FLAG_HIDDEN)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Composites the snapshot of a widget over the layer, static widgets seldom overlap so this is mostly a copy
+static void static_layer_blend(static_layer_t *layer, const lv_img_dsc_t *snapshot, const lv_area_t *area) {
+    uint32_t layer_stride = layer->img.header.w * STATIC_LAYER_PX_SIZE;
+    uint32_t stride = snapshot->header.w * STATIC_LAYER_PX_SIZE;
+    uint8_t *dest_row = (uint8_t *)layer->img.data + (area->y1 - layer->area.y1) * layer_stride
+                        + (area->x1 - layer->area.x1) * STATIC_LAYER_PX_SIZE;
+    const uint8_t *src_row = snapshot->data;
+
+    for (uint32_t y = 0; y < snapshot->header.h; y++, dest_row += layer_stride, src_row += stride) {
+        for (uint32_t x = 0; x < snapshot->header.w; x++) {
+            const uint8_t *src = src_row + x * STATIC_LAYER_PX_SIZE;
+            uint8_t *dest = dest_row + x * STATIC_LAYER_PX_SIZE;
+            lv_opa_t src_a = src[STATIC_LAYER_PX_SIZE - 1];
+            lv_opa_t dest_a = dest[STATIC_LAYER_PX_SIZE - 1];
+            if (src_a == LV_OPA_TRANSP) {
+                continue;
+            }
+            if (src_a == LV_OPA_COVER || dest_a == LV_OPA_TRANSP) {
+                memcpy(dest, src, STATIC_LAYER_PX_SIZE);
+                continue;
+            }
+            lv_color_t src_c, dest_c;
+            memcpy(&src_c, src, sizeof(lv_color_t));
+            memcpy(&dest_c, dest, sizeof(lv_color_t));
+            lv_opa_t a = src_a + LV_UDIV255(dest_a * (LV_OPA_COVER - src_a));
+            lv_color_t c = lv_color_mix(src_c, dest_c, (src_a * LV_OPA_COVER) / a);
+            memcpy(dest, &c, sizeof(lv_color_t));
+            dest[STATIC_LAYER_PX_SIZE - 1] = a;
+        }
+    }
+}
+
+static void static_layer_free_img(static_layer_t *layer) {
+    if (layer->img.data) {
+        lv_img_cache_invalidate_src(&layer->img);
+        static_layer_stats.bytes -= layer->img.data_size;
+        lv_mem_free((void *)layer->img.data);
+        layer->img.data = NULL;
+        layer->img.data_size = 0;
+    }
+}
+
+// Snapshots each visible static widget and flattens them into one image. The widgets are only drawn
+// for their own snapshot, the rest of the time they're transparent and LVGL skips them.
+static void static_layer_rebuild(static_layer_t *layer) {
+    if (layer->img.data) {
+        lv_obj_invalidate_area(layer->container, &layer->area);
+    }
+    static_layer_free_img(layer);
+    layer->valid = true;
+
+    bool any = false;
+    for (uint32_t i = 0; i < layer->count; i++) {
+        static_layer_widget_t *widget = &layer->widgets[i];
+        if (widget->visible) {
+            if (any) {
+                _lv_area_join(&layer->area, &layer->area, &widget->area);
+            } else {
+                layer->area = widget->area;
+                any = true;
+            }
+        }
+    }
+    if (!any) {
+        return;
+    }
+
+    uint32_t w = lv_area_get_width(&layer->area);
+    uint32_t h = lv_area_get_height(&layer->area);
+    uint32_t size = w * h * STATIC_LAYER_PX_SIZE;
+    uint8_t *data = lv_mem_alloc(size);
+    if (!data) {
+        // Draw the widgets as usual rather than leaving them out
+        LV_LOG_WARN("no memory for a %" LV_PRIu32 "x%" LV_PRIu32 " static layer", w, h);
+        for (uint32_t i = 0; i < layer->count; i++) {
+            lv_obj_remove_local_style_prop(layer->widgets[i].obj, LV_STYLE_OPA, LV_PART_MAIN);
+        }
+        return;
+    }
+    lv_memset_00(data, size);
+    layer->img.header.always_zero = 0;
+    layer->img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    layer->img.header.w = w;
+    layer->img.header.h = h;
+    layer->img.data = data;
+    layer->img.data_size = size;
+
+    for (uint32_t i = 0; i < layer->count; i++) {
+        static_layer_widget_t *widget = &layer->widgets[i];
+        if (!widget->visible) {
+            continue;
+        }
+        lv_obj_remove_local_style_prop(widget->obj, LV_STYLE_OPA, LV_PART_MAIN);
+        lv_img_dsc_t *snapshot = lv_snapshot_take(widget->obj, LV_IMG_CF_TRUE_COLOR_ALPHA);
+        if (snapshot) {
+            static_layer_blend(layer, snapshot, &widget->area);
+            lv_snapshot_free(snapshot);
+            lv_obj_set_style_opa(widget->obj, LV_OPA_TRANSP, LV_PART_MAIN);
+        }
+    }
+
+    lv_obj_invalidate_area(layer->container, &layer->area);
+    static_layer_stats.bytes += size;
+    static_layer_stats.rebuilds++;
+}
+
+static void static_layer_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    static_layer_t *layer = lv_event_get_user_data(e);
+
+    if (code == LV_EVENT_DRAW_MAIN) {
+        // After the container's own background and before its children
+        if (layer->img.data) {
+            lv_draw_img_dsc_t dsc;
+            lv_draw_img_dsc_init(&dsc);
+            lv_draw_img(lv_event_get_draw_ctx(e), &dsc, &layer->area, &layer->img);
+        }
+    } else if (code == LV_EVENT_DELETE) {
+        static_layer_free_img(layer);
+        static_layer_stats.layers--;
+        static_layer_stats.widgets -= layer->count;
+        lv_mem_free(layer);
+    }
+}
+
+static_layer_t *static_layer_create(lv_obj_t *container, static_layer_bound_cb_t is_bound) {
+    if (!STATIC_LAYER_ENABLED) {
+        return NULL;
+    }
+    uint32_t count = static_layer_collect(container, is_bound, NULL);
+    static_layer_t *layer = lv_mem_alloc(sizeof(static_layer_t) + count * sizeof(static_layer_widget_t));
+    LV_ASSERT_MALLOC(layer);
+    if (!layer) {
+        return NULL;
+    }
+    lv_memset_00(layer, sizeof(static_layer_t) + count * sizeof(static_layer_widget_t));
+    layer->container = container;
+    layer->widgets = (static_layer_widget_t *)(layer + 1);
+    layer->count = static_layer_collect(container, is_bound, layer->widgets);
+    lv_obj_add_event_cb(container, static_layer_event_cb, LV_EVENT_ALL, layer);
+
+    static_layer_stats.layers++;
+    static_layer_stats.widgets += count;
+    return layer;
+}
+
+void static_layer_update(static_layer_t *layer) {
+    if (!layer) {
+        return;
+    }
+    // Positions of the static widgets may depend on the layout of the containers around them
+    lv_obj_update_layout(layer->container);
+
+    bool changed = !layer->valid;
+    for (uint32_t i = 0; i < layer->count; i++) {
+        static_layer_widget_t *widget = &layer->widgets[i];
+        lv_area_t area;
+        static_layer_widget_area(widget->obj, &area);
+        bool visible = static_layer_widget_visible(layer, widget->obj);
+        if (visible != widget->visible || (visible && !_lv_area_is_equal(&area, &widget->area))) {
+            widget->area = area;
+            widget->visible = visible;
+            changed = true;
+        }
+    }
+    if (changed) {
+        static_layer_rebuild(layer);
+    }
+}
+
+void static_layer_get_stats(static_layer_stats_t *stats) {
+    // Written by the LVGL task, the fields may be a rebuild apart
+    *stats = static_layer_stats;
+}
@@ -0,0 +1,49 @@
+#ifndef EEZ_LVGL_UI_STATIC_LAYER_H
+#define EEZ_LVGL_UI_STATIC_LAYER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <lvgl.h>
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A static layer flattens the widgets of a container that nothing updates (titles, unit labels, icons) into
+// one cached ARGB snapshot. The container blits it under its children and the static widgets themselves are
+// skipped, so an invalidated area only re-renders the bound widgets in it.
+#ifdef CONFIG_UI_STATIC_LAYER
+#define STATIC_LAYER_ENABLED (1)
+#else
+#define STATIC_LAYER_ENABLED (0)
+#endif
+
+typedef struct _static_layer_t static_layer_t;
+
+// Returns true for the widgets a tick or an event handler changes, they're left out of the layer
+typedef bool (*static_layer_bound_cb_t)(lv_obj_t *obj);
+
+typedef struct {
+    uint32_t layers;    // Containers drawn from a static layer
+    uint32_t widgets;   // Static widgets flattened into the layers
+    uint32_t rebuilds;  // Snapshots taken since start-up
+    uint32_t bytes;     // Memory held by the snapshots
+} static_layer_stats_t;
+
+// Opts `container` in. The leaf widgets `is_bound` returns false for, that aren't clickable and whose parent
+// doesn't place them with a flex or grid layout (they move with their siblings' texts), are static.
+// Returns NULL if static layers are disabled. The layer is freed with the container.
+static_layer_t *static_layer_create(lv_obj_t *container, static_layer_bound_cb_t is_bound);
+// Call after the bound widgets were updated, outside of rendering. Takes the snapshot after the first layout
+// and again whenever a static widget moved (e.g. with a container the flow moved) or was shown or hidden.
+void static_layer_update(static_layer_t *layer);
+void static_layer_get_stats(static_layer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*EEZ_LVGL_UI_STATIC_LAYER_H*/
@@ -608,14 +608,20 @@ ActionExecFunc actions[] = {
 #if defined(EEZ_FOR_LVGL)
 
 void ui_init() {
+    native_vars_refresh();
     eez_flow_init(assets, sizeof(assets), (lv_obj_t **)&objects, sizeof(objects), images, sizeof(images), actions);
 }
 
 void ui_tick() {
+    native_vars_refresh();
     eez_flow_tick();
     tick_screen(g_currentScreen);
 }
 
+bool ui_tick_needed() {
+    return native_vars_pending() || eez_flow_tick_needed() || tick_screen_pending();
+}
+
 #else
 
 static int16_t currentScreen = -1;
@@ -634,13 +640,19 @@ void loadScreen(enum ScreensEnum screenId) {
 }
 
 void ui_init() {
+    native_vars_refresh();
     create_screens();
     loadScreen(SCREEN_ID_MAIN);
     
 }
 
 void ui_tick() {
+    native_vars_refresh();
     tick_screen(currentScreen);
 }
 
+bool ui_tick_needed() {
+    return native_vars_pending() || tick_screen_pending();
+}
+
 #endif
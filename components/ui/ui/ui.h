@@ -19,6 +19,9 @@ extern const uint8_t assets[8976];
 
 void ui_init();
 void ui_tick();
+// Whether ui_tick() has anything to do: a native variable was written, the flow has queued work or an
+// arc holds back a value
+bool ui_tick_needed();
 
 #if !defined(EEZ_FOR_LVGL)
 void loadScreen(enum ScreensEnum screenId);
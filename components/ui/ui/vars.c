@@ -0,0 +1,250 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "vars.h"
+
+#define NATIVE_VAR_OFFSET(field) offsetof(native_vars_snapshot_t, field)
+
+// Where each native variable lives in native_vars_snapshot_t
+static const uint16_t native_var_offsets[NATIVE_VAR_COUNT] = {
+    [NATIVE_VAR_INV_SWITCH]      = NATIVE_VAR_OFFSET(inv_switch),
+    [NATIVE_VAR_INV_MODE]        = NATIVE_VAR_OFFSET(inv_mode),
+    [NATIVE_VAR_INV_ERROR]       = NATIVE_VAR_OFFSET(inv_error),
+    [NATIVE_VAR_AC_WATTS]        = NATIVE_VAR_OFFSET(ac_watts),
+    [NATIVE_VAR_BATT_SOC]        = NATIVE_VAR_OFFSET(batt_soc),
+    [NATIVE_VAR_BATT_VOLT]       = NATIVE_VAR_OFFSET(batt_volt),
+    [NATIVE_VAR_BATT_AMP]        = NATIVE_VAR_OFFSET(batt_amp),
+    [NATIVE_VAR_BATT_TEMP]       = NATIVE_VAR_OFFSET(batt_temp),
+    [NATIVE_VAR_BATT_ALARM]      = NATIVE_VAR_OFFSET(batt_alarm),
+    [NATIVE_VAR_SOLAR_WATTS]     = NATIVE_VAR_OFFSET(solar_watts),
+    [NATIVE_VAR_SOLAR_YIELD]     = NATIVE_VAR_OFFSET(solar_yield),
+    [NATIVE_VAR_SOLAR_MODE]      = NATIVE_VAR_OFFSET(solar_mode),
+    [NATIVE_VAR_SOLAR_ERROR]     = NATIVE_VAR_OFFSET(solar_error),
+    [NATIVE_VAR_IP_ADDR]         = NATIVE_VAR_OFFSET(ip_addr),
+    [NATIVE_VAR_BACKLIGHT_DELAY] = NATIVE_VAR_OFFSET(backlight_delay),
+    [NATIVE_VAR_INV_MAC]         = NATIVE_VAR_OFFSET(inv_mac),
+    [NATIVE_VAR_INV_KEY]         = NATIVE_VAR_OFFSET(inv_key),
+    [NATIVE_VAR_INV_PIN]         = NATIVE_VAR_OFFSET(inv_pin),
+    [NATIVE_VAR_MPPT_MAC]        = NATIVE_VAR_OFFSET(mppt_mac),
+    [NATIVE_VAR_MPPT_KEY]        = NATIVE_VAR_OFFSET(mppt_key),
+    [NATIVE_VAR_BMV_MAC]         = NATIVE_VAR_OFFSET(bmv_mac),
+    [NATIVE_VAR_BMV_KEY]         = NATIVE_VAR_OFFSET(bmv_key),
+};
+
+// Texts of the Victron device states
+static const char *native_mode_text(native_code_t mode) {
+    switch (mode) {
+    case VICTRON_MODE_OFF:                 return "Off";
+    case VICTRON_MODE_LOW_POWER:           return "Low power";
+    case VICTRON_MODE_FAULT:               return "Fault";
+    case VICTRON_MODE_BULK:                return "Bulk";
+    case VICTRON_MODE_ABSORPTION:          return "Absorption";
+    case VICTRON_MODE_FLOAT:               return "Float";
+    case VICTRON_MODE_STORAGE:             return "Storage";
+    case VICTRON_MODE_EQUALIZE:            return "Equalize";
+    case VICTRON_MODE_PASSTHRU:            return "Passthru";
+    case VICTRON_MODE_INVERTING:           return "Inverting";
+    case VICTRON_MODE_ASSISTING:           return "Assisting";
+    case VICTRON_MODE_POWER_SUPPLY:        return "Power supply";
+    case VICTRON_MODE_SUSTAIN:             return "Sustain";
+    case VICTRON_MODE_STARTING_UP:         return "Starting up";
+    case VICTRON_MODE_REPEATED_ABSORPTION: return "Repeated absorption";
+    case VICTRON_MODE_AUTO_EQUALIZE:       return "Auto equalize";
+    case VICTRON_MODE_BATTERY_SAFE:        return "Battery safe";
+    case VICTRON_MODE_LOAD_DETECT:         return "Load detect";
+    case VICTRON_MODE_BLOCKED:             return "Blocked";
+    case VICTRON_MODE_TEST:                return "Test";
+    case VICTRON_MODE_EXTERNAL_CONTROL:    return "External control";
+    case VICTRON_MODE_NOT_APPLICABLE:      return "";
+    default:                               return "?";
+    }
+}
+
+// Texts of the Victron charger errors, no error shows nothing
+static const char *native_charger_error_text(native_code_t error) {
+    switch (error) {
+    case VICTRON_CHARGER_ERROR_NONE:                   return "";
+    case VICTRON_CHARGER_ERROR_BATTERY_VOLTAGE_HIGH:   return "Battery voltage too high";
+    case VICTRON_CHARGER_ERROR_TEMPERATURE_HIGH:       return "Charger temperature too high";
+    case VICTRON_CHARGER_ERROR_OVER_CURRENT:           return "Charger over current";
+    case VICTRON_CHARGER_ERROR_CURRENT_REVERSED:       return "Charger current reversed";
+    case VICTRON_CHARGER_ERROR_BULK_TIME_LIMIT:        return "Bulk time limit exceeded";
+    case VICTRON_CHARGER_ERROR_CURRENT_SENSOR:         return "Current sensor issue";
+    case VICTRON_CHARGER_ERROR_TERMINALS_OVERHEATED:   return "Terminals overheated";
+    case VICTRON_CHARGER_ERROR_CONVERTER:              return "Converter issue";
+    case VICTRON_CHARGER_ERROR_INPUT_VOLTAGE_HIGH:     return "Input voltage too high";
+    case VICTRON_CHARGER_ERROR_INPUT_CURRENT_HIGH:     return "Input current too high";
+    case VICTRON_CHARGER_ERROR_INPUT_SHUTDOWN_VOLTAGE: return "Input shutdown, battery voltage";
+    case VICTRON_CHARGER_ERROR_INPUT_SHUTDOWN_CURRENT: return "Input shutdown, current while off";
+    case VICTRON_CHARGER_ERROR_LOST_COMMUNICATION:     return "Lost communication";
+    case VICTRON_CHARGER_ERROR_SYNCHRONISED_CHARGING:  return "Synchronised charging issue";
+    case VICTRON_CHARGER_ERROR_BMS_CONNECTION_LOST:    return "BMS connection lost";
+    case VICTRON_CHARGER_ERROR_NETWORK_MISCONFIGURED:  return "Network misconfigured";
+    case VICTRON_CHARGER_ERROR_CALIBRATION_LOST:       return "Calibration data lost";
+    case VICTRON_CHARGER_ERROR_INCOMPATIBLE_FIRMWARE:  return "Incompatible firmware";
+    case VICTRON_CHARGER_ERROR_SETTINGS_INVALID:       return "Settings invalid";
+    case VICTRON_CHARGER_ERROR_NOT_APPLICABLE:         return "";
+    default:                                           return "?";
+    }
+}
+
+// Texts of the VE.Bus errors, no error shows nothing
+static const char *native_vebus_error_text(native_code_t error) {
+    switch (error) {
+    case VICTRON_VEBUS_ERROR_NONE:                   return "";
+    case VICTRON_VEBUS_ERROR_PHASE_SWITCHED_OFF:     return "Other phase switched off";
+    case VICTRON_VEBUS_ERROR_MIXED_MK2:              return "New and old MK2 mixed";
+    case VICTRON_VEBUS_ERROR_DEVICES_MISMATCH:       return "Devices found don't match";
+    case VICTRON_VEBUS_ERROR_NO_OTHER_DEVICE:        return "No other device detected";
+    case VICTRON_VEBUS_ERROR_AC_OUT_OVERVOLTAGE:     return "Overvoltage on AC out";
+    case VICTRON_VEBUS_ERROR_DDC_PROGRAM:            return "DDC program error";
+    case VICTRON_VEBUS_ERROR_BMS_WITHOUT_ASSISTANT:  return "BMS without assistant";
+    case VICTRON_VEBUS_ERROR_GROUND_RELAY_TEST:      return "Ground relay test failed";
+    case VICTRON_VEBUS_ERROR_TIME_SYNC:              return "Time synchronisation issue";
+    case VICTRON_VEBUS_ERROR_RELAY_TEST:             return "Relay test fault";
+    case VICTRON_VEBUS_ERROR_CONFIG_MISMATCH:        return "Configuration mismatch";
+    case VICTRON_VEBUS_ERROR_CANNOT_TRANSMIT:        return "Device can't transmit";
+    case VICTRON_VEBUS_ERROR_COMBINATION:            return "VE.Bus combination error";
+    case VICTRON_VEBUS_ERROR_DONGLE_MISSING:         return "Dongle missing";
+    case VICTRON_VEBUS_ERROR_PHASE_MASTER_MISSING:   return "Phase master missing";
+    case VICTRON_VEBUS_ERROR_OVERVOLTAGE:            return "Overvoltage";
+    case VICTRON_VEBUS_ERROR_SLAVE_NO_AC_INPUT:      return "Slave has no AC input";
+    case VICTRON_VEBUS_ERROR_CANNOT_BE_SLAVE:        return "Device can't be slave";
+    case VICTRON_VEBUS_ERROR_SWITCH_OVER_PROTECTION: return "Switch over protection";
+    case VICTRON_VEBUS_ERROR_INCOMPATIBLE_FIRMWARE:  return "Incompatible firmware";
+    case VICTRON_VEBUS_ERROR_INTERNAL:               return "Internal error";
+    case VICTRON_VEBUS_ERROR_NOT_APPLICABLE:         return "";
+    default:                                         return "?";
+    }
+}
+
+// Text of the alarm reason, several alarms at once show the one of the lowest bit
+static const char *native_alarm_text(native_code_t alarm) {
+    switch (alarm & -alarm) {
+    case 0:                                  return "";
+    case VICTRON_ALARM_LOW_VOLTAGE:          return "Low voltage";
+    case VICTRON_ALARM_HIGH_VOLTAGE:         return "High voltage";
+    case VICTRON_ALARM_LOW_SOC:              return "Low SOC";
+    case VICTRON_ALARM_LOW_STARTER_VOLTAGE:  return "Low starter voltage";
+    case VICTRON_ALARM_HIGH_STARTER_VOLTAGE: return "High starter voltage";
+    case VICTRON_ALARM_LOW_TEMPERATURE:      return "Low temperature";
+    case VICTRON_ALARM_HIGH_TEMPERATURE:     return "High temperature";
+    case VICTRON_ALARM_MID_VOLTAGE:          return "Mid voltage";
+    case VICTRON_ALARM_OVERLOAD:             return "Overload";
+    case VICTRON_ALARM_DC_RIPPLE:            return "DC ripple";
+    case VICTRON_ALARM_LOW_AC_OUT_VOLTAGE:   return "Low V AC out";
+    case VICTRON_ALARM_HIGH_AC_OUT_VOLTAGE:  return "High V AC out";
+    case VICTRON_ALARM_SHORT_CIRCUIT:        return "Short circuit";
+    case VICTRON_ALARM_BMS_LOCKOUT:          return "BMS lockout";
+    default:                                 return "?";
+    }
+}
+
+// Written by the native code, `seq` is odd while a write is in progress
+static native_vars_snapshot_t native_vars_shared;
+// Serializes the writers, which also can't be preempted half way through a write
+static portMUX_TYPE native_vars_lock = portMUX_INITIALIZER_UNLOCKED;
+
+native_vars_snapshot_t native_vars_tick;
+// Sequence number native_vars_tick was taken at, read by the native code
+static uint32_t native_vars_tick_seq;
+
+static void native_vars_seq_begin(void) {
+    __atomic_store_n(&native_vars_shared.seq, native_vars_shared.seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void native_vars_seq_end(void) {
+    __atomic_store_n(&native_vars_shared.seq, native_vars_shared.seq + 1, __ATOMIC_RELEASE);
+}
+
+static void *native_var_write_begin(enum NativeVariables var) {
+    taskENTER_CRITICAL(&native_vars_lock);
+    native_vars_seq_begin();
+    native_vars_shared.versions[var]++;
+    return (uint8_t *)&native_vars_shared + native_var_offsets[var];
+}
+
+static void native_var_write_end(void) {
+    native_vars_seq_end();
+    taskEXIT_CRITICAL(&native_vars_lock);
+}
+
+void native_var_publish_bool(enum NativeVariables var, bool value) {
+    *(bool *)native_var_write_begin(var) = value;
+    native_var_write_end();
+}
+
+void native_var_publish_int(enum NativeVariables var, int32_t value) {
+    *(int32_t *)native_var_write_begin(var) = value;
+    native_var_write_end();
+}
+
+void native_var_publish_float(enum NativeVariables var, float value) {
+    *(float *)native_var_write_begin(var) = value;
+    native_var_write_end();
+}
+
+void native_var_publish_string(enum NativeVariables var, const char *value) {
+    strlcpy(native_var_write_begin(var), value, NATIVE_VAR_STRING_SIZE);
+    native_var_write_end();
+}
+
+void native_var_publish_code(enum NativeVariables var, native_code_t code) {
+    native_code_t *value = (native_code_t *)((uint8_t *)&native_vars_shared + native_var_offsets[var]);
+
+    // Most updates repeat the current code, those don't touch the version
+    taskENTER_CRITICAL(&native_vars_lock);
+    if (*value != code) {
+        native_vars_seq_begin();
+        native_vars_shared.versions[var]++;
+        *value = code;
+        native_vars_seq_end();
+    }
+    taskEXIT_CRITICAL(&native_vars_lock);
+}
+
+void native_var_changed(enum NativeVariables var) {
+    native_var_write_begin(var);
+    native_var_write_end();
+}
+
+void native_vars_snapshot(native_vars_snapshot_t *snapshot) {
+    uint32_t seq;
+    do {
+        // A writer on the other core holds it only for a short copy
+        while ((seq = __atomic_load_n(&native_vars_shared.seq, __ATOMIC_ACQUIRE)) & 1) {
+        }
+        memcpy(snapshot, &native_vars_shared, sizeof(*snapshot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&native_vars_shared.seq, __ATOMIC_RELAXED) != seq);
+    snapshot->seq = seq;
+}
+
+void native_vars_refresh(void) {
+    native_vars_snapshot(&native_vars_tick);
+    __atomic_store_n(&native_vars_tick_seq, native_vars_tick.seq, __ATOMIC_RELAXED);
+}
+
+bool native_vars_pending(void) {
+    return __atomic_load_n(&native_vars_shared.seq, __ATOMIC_RELAXED) != __atomic_load_n(&native_vars_tick_seq, __ATOMIC_RELAXED);
+}
+
+const void *native_var_value(enum NativeVariables var) {
+    const void *value = (const uint8_t *)&native_vars_tick + native_var_offsets[var];
+    switch (var) {
+    case NATIVE_VAR_INV_MODE:
+    case NATIVE_VAR_SOLAR_MODE:
+        return native_mode_text(*(const native_code_t *)value);
+    case NATIVE_VAR_INV_ERROR:
+        return native_vebus_error_text(*(const native_code_t *)value);
+    case NATIVE_VAR_SOLAR_ERROR:
+        return native_charger_error_text(*(const native_code_t *)value);
+    case NATIVE_VAR_BATT_ALARM:
+        return native_alarm_text(*(const native_code_t *)value);
+    default:
+        return value;
+    }
+}
@@ -1,6 +1,7 @@
 #ifndef EEZ_LVGL_UI_VARS_H
 #define EEZ_LVGL_UI_VARS_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -10,6 +11,106 @@ extern "C" {
 
 // enum declarations
 
+// Enum like native variables (inverter and solar modes, errors and battery alarms) hold the Victron protocol
+// code: a VictronMode, a VictronChargerError, a VictronVeBusError or VictronAlarm bits. The UI reads the matching
+// static text.
+typedef uint16_t native_code_t;
+
+// Victron device states, the modes of the inverter and the solar charger
+enum VictronMode {
+    VICTRON_MODE_OFF = 0,
+    VICTRON_MODE_LOW_POWER = 1,
+    VICTRON_MODE_FAULT = 2,
+    VICTRON_MODE_BULK = 3,
+    VICTRON_MODE_ABSORPTION = 4,
+    VICTRON_MODE_FLOAT = 5,
+    VICTRON_MODE_STORAGE = 6,
+    VICTRON_MODE_EQUALIZE = 7,
+    VICTRON_MODE_PASSTHRU = 8,
+    VICTRON_MODE_INVERTING = 9,
+    VICTRON_MODE_ASSISTING = 10,
+    VICTRON_MODE_POWER_SUPPLY = 11,
+    VICTRON_MODE_SUSTAIN = 244,
+    VICTRON_MODE_STARTING_UP = 245,
+    VICTRON_MODE_REPEATED_ABSORPTION = 246,
+    VICTRON_MODE_AUTO_EQUALIZE = 247,
+    VICTRON_MODE_BATTERY_SAFE = 248,
+    VICTRON_MODE_LOAD_DETECT = 249,
+    VICTRON_MODE_BLOCKED = 250,
+    VICTRON_MODE_TEST = 251,
+    VICTRON_MODE_EXTERNAL_CONTROL = 252,
+    VICTRON_MODE_NOT_APPLICABLE = 255
+};
+
+// Victron charger errors, reported by the solar charger
+enum VictronChargerError {
+    VICTRON_CHARGER_ERROR_NONE = 0,
+    VICTRON_CHARGER_ERROR_BATTERY_VOLTAGE_HIGH = 2,
+    VICTRON_CHARGER_ERROR_TEMPERATURE_HIGH = 17,
+    VICTRON_CHARGER_ERROR_OVER_CURRENT = 18,
+    VICTRON_CHARGER_ERROR_CURRENT_REVERSED = 19,
+    VICTRON_CHARGER_ERROR_BULK_TIME_LIMIT = 20,
+    VICTRON_CHARGER_ERROR_CURRENT_SENSOR = 21,
+    VICTRON_CHARGER_ERROR_TERMINALS_OVERHEATED = 26,
+    VICTRON_CHARGER_ERROR_CONVERTER = 28,
+    VICTRON_CHARGER_ERROR_INPUT_VOLTAGE_HIGH = 33,
+    VICTRON_CHARGER_ERROR_INPUT_CURRENT_HIGH = 34,
+    VICTRON_CHARGER_ERROR_INPUT_SHUTDOWN_VOLTAGE = 38,
+    VICTRON_CHARGER_ERROR_INPUT_SHUTDOWN_CURRENT = 39,
+    VICTRON_CHARGER_ERROR_LOST_COMMUNICATION = 65,
+    VICTRON_CHARGER_ERROR_SYNCHRONISED_CHARGING = 66,
+    VICTRON_CHARGER_ERROR_BMS_CONNECTION_LOST = 67,
+    VICTRON_CHARGER_ERROR_NETWORK_MISCONFIGURED = 68,
+    VICTRON_CHARGER_ERROR_CALIBRATION_LOST = 116,
+    VICTRON_CHARGER_ERROR_INCOMPATIBLE_FIRMWARE = 117,
+    VICTRON_CHARGER_ERROR_SETTINGS_INVALID = 119,
+    VICTRON_CHARGER_ERROR_NOT_APPLICABLE = 255
+};
+
+// VE.Bus errors, reported by the inverter
+enum VictronVeBusError {
+    VICTRON_VEBUS_ERROR_NONE = 0,
+    VICTRON_VEBUS_ERROR_PHASE_SWITCHED_OFF = 1,
+    VICTRON_VEBUS_ERROR_MIXED_MK2 = 2,
+    VICTRON_VEBUS_ERROR_DEVICES_MISMATCH = 3,
+    VICTRON_VEBUS_ERROR_NO_OTHER_DEVICE = 4,
+    VICTRON_VEBUS_ERROR_AC_OUT_OVERVOLTAGE = 5,
+    VICTRON_VEBUS_ERROR_DDC_PROGRAM = 6,
+    VICTRON_VEBUS_ERROR_BMS_WITHOUT_ASSISTANT = 7,
+    VICTRON_VEBUS_ERROR_GROUND_RELAY_TEST = 8,
+    VICTRON_VEBUS_ERROR_TIME_SYNC = 10,
+    VICTRON_VEBUS_ERROR_RELAY_TEST = 11,
+    VICTRON_VEBUS_ERROR_CONFIG_MISMATCH = 12,
+    VICTRON_VEBUS_ERROR_CANNOT_TRANSMIT = 14,
+    VICTRON_VEBUS_ERROR_COMBINATION = 15,
+    VICTRON_VEBUS_ERROR_DONGLE_MISSING = 16,
+    VICTRON_VEBUS_ERROR_PHASE_MASTER_MISSING = 17,
+    VICTRON_VEBUS_ERROR_OVERVOLTAGE = 18,
+    VICTRON_VEBUS_ERROR_SLAVE_NO_AC_INPUT = 19,
+    VICTRON_VEBUS_ERROR_CANNOT_BE_SLAVE = 20,
+    VICTRON_VEBUS_ERROR_SWITCH_OVER_PROTECTION = 24,
+    VICTRON_VEBUS_ERROR_INCOMPATIBLE_FIRMWARE = 25,
+    VICTRON_VEBUS_ERROR_INTERNAL = 26,
+    VICTRON_VEBUS_ERROR_NOT_APPLICABLE = 255
+};
+
+// Victron alarm reason bits, reported by the battery monitor
+enum VictronAlarm {
+    VICTRON_ALARM_LOW_VOLTAGE = 1 << 0,
+    VICTRON_ALARM_HIGH_VOLTAGE = 1 << 1,
+    VICTRON_ALARM_LOW_SOC = 1 << 2,
+    VICTRON_ALARM_LOW_STARTER_VOLTAGE = 1 << 3,
+    VICTRON_ALARM_HIGH_STARTER_VOLTAGE = 1 << 4,
+    VICTRON_ALARM_LOW_TEMPERATURE = 1 << 5,
+    VICTRON_ALARM_HIGH_TEMPERATURE = 1 << 6,
+    VICTRON_ALARM_MID_VOLTAGE = 1 << 7,
+    VICTRON_ALARM_OVERLOAD = 1 << 8,
+    VICTRON_ALARM_DC_RIPPLE = 1 << 9,
+    VICTRON_ALARM_LOW_AC_OUT_VOLTAGE = 1 << 10,
+    VICTRON_ALARM_HIGH_AC_OUT_VOLTAGE = 1 << 11,
+    VICTRON_ALARM_SHORT_CIRCUIT = 1 << 12,
+    VICTRON_ALARM_BMS_LOCKOUT = 1 << 13
+};
 
 
 // Flow global variables
@@ -20,6 +121,93 @@ enum FlowGlobalVariables {
 
 // Native global variables
 
+enum NativeVariables {
+    NATIVE_VAR_INV_SWITCH,
+    NATIVE_VAR_INV_MODE,
+    NATIVE_VAR_INV_ERROR,
+    NATIVE_VAR_AC_WATTS,
+    NATIVE_VAR_BATT_SOC,
+    NATIVE_VAR_BATT_VOLT,
+    NATIVE_VAR_BATT_AMP,
+    NATIVE_VAR_BATT_TEMP,
+    NATIVE_VAR_BATT_ALARM,
+    NATIVE_VAR_SOLAR_WATTS,
+    NATIVE_VAR_SOLAR_YIELD,
+    NATIVE_VAR_SOLAR_MODE,
+    NATIVE_VAR_SOLAR_ERROR,
+    NATIVE_VAR_IP_ADDR,
+    NATIVE_VAR_BACKLIGHT_DELAY,
+    NATIVE_VAR_INV_MAC,
+    NATIVE_VAR_INV_KEY,
+    NATIVE_VAR_INV_PIN,
+    NATIVE_VAR_MPPT_MAC,
+    NATIVE_VAR_MPPT_KEY,
+    NATIVE_VAR_BMV_MAC,
+    NATIVE_VAR_BMV_KEY,
+    NATIVE_VAR_COUNT
+};
+
+// Size of the string slots in native_vars_snapshot_t, longer values are truncated
+#define NATIVE_VAR_STRING_SIZE 64
+
+// Copy of every native variable, taken in one go under the writers' sequence lock
+typedef struct {
+    uint32_t seq;                              // Sequence number the copy was taken at
+    uint32_t versions[NATIVE_VAR_COUNT];       // Incremented whenever a variable is written
+    int32_t ac_watts;
+    int32_t batt_temp;
+    int32_t solar_watts;
+    int32_t solar_yield;
+    int32_t backlight_delay;
+    float batt_soc;
+    float batt_volt;
+    float batt_amp;
+    bool inv_switch;
+    native_code_t inv_mode;
+    native_code_t inv_error;
+    native_code_t batt_alarm;
+    native_code_t solar_mode;
+    native_code_t solar_error;
+    char ip_addr[NATIVE_VAR_STRING_SIZE];
+    char inv_mac[NATIVE_VAR_STRING_SIZE];
+    char inv_key[NATIVE_VAR_STRING_SIZE];
+    char inv_pin[NATIVE_VAR_STRING_SIZE];
+    char mppt_mac[NATIVE_VAR_STRING_SIZE];
+    char mppt_key[NATIVE_VAR_STRING_SIZE];
+    char bmv_mac[NATIVE_VAR_STRING_SIZE];
+    char bmv_key[NATIVE_VAR_STRING_SIZE];
+} native_vars_snapshot_t;
+
+// Snapshot the UI evaluates against, refreshed at the start of every tick
+extern native_vars_snapshot_t native_vars_tick;
+
+// Called by the native code to publish a new value, bumps the variable's version
+extern void native_var_publish_bool(enum NativeVariables var, bool value);
+extern void native_var_publish_int(enum NativeVariables var, int32_t value);
+extern void native_var_publish_float(enum NativeVariables var, float value);
+extern void native_var_publish_string(enum NativeVariables var, const char *value);
+// Publishes the protocol code of an enum like variable, only bumps the version if the code changed
+extern void native_var_publish_code(enum NativeVariables var, native_code_t code);
+
+// Called by the native code to bump a variable's version without changing its value
+extern void native_var_changed(enum NativeVariables var);
+
+// Copies a consistent view of every native variable into `snapshot`
+extern void native_vars_snapshot(native_vars_snapshot_t *snapshot);
+
+// Refreshes native_vars_tick, called by the UI before evaluating anything
+extern void native_vars_refresh(void);
+
+// Whether a variable was written since native_vars_tick was refreshed
+extern bool native_vars_pending(void);
+
+// Returns a pointer to the value of `var` in native_vars_tick, or to the static text of an enum like variable's code
+extern const void *native_var_value(enum NativeVariables var);
+
+static inline uint32_t native_var_version(enum NativeVariables var) {
+    return native_vars_tick.versions[var];
+}
+
 extern bool get_var_inv_switch();
 extern void set_var_inv_switch(bool value);
 extern const char *get_var_inv_mode();
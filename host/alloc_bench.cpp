@@ -0,0 +1,223 @@
+/*
+ * Microbenchmark of the eez-flow allocator: a churn of the block sizes the flow allocates (StringRefs and their
+ * texts, arrays, watch list nodes, component states) is run through the size class slabs of `eez::alloc()`
+ * and through `lv_mem_alloc()`, which every block went to before. Throughput and the memory each path holds
+ * for the same live blocks are reported, and every block is checked to keep its contents until it's freed.
+ *
+ * Usage: alloc_bench [ops]
+ */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "eez-flow.h"
+
+#define ALLOC_BENCH_DEFAULT_OPS (2000000)
+#define ALLOC_BENCH_SLOTS (384) // Blocks alive at most, about half of them at any time
+
+typedef struct
+{
+    void *ptr;
+    uint32_t size;
+} alloc_bench_slot_t;
+
+typedef struct
+{
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*free)(void *ptr);
+} alloc_bench_path_t;
+
+static alloc_bench_slot_t slots[ALLOC_BENCH_SLOTS];
+
+static void *slab_alloc(size_t size)
+{
+    return eez::alloc(size, 0);
+}
+
+static void slab_free(void *ptr)
+{
+    eez::free(ptr);
+}
+
+static void *heap_alloc(size_t size)
+{
+    return lv_mem_alloc(size);
+}
+
+static void heap_free(void *ptr)
+{
+    lv_mem_free(ptr);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Deterministic pseudo-random number in [0, n)
+static uint32_t trace_rand(uint32_t *state, uint32_t n)
+{
+    *state = *state * 1664525 + 1013904223;
+    return (*state >> 8) % n;
+}
+
+// Size of the next block, in the proportions the flow allocates them
+static uint32_t trace_size(uint32_t *state)
+{
+    const uint32_t kind = trace_rand(state, 100);
+    if (kind < 35)
+    {
+        return 24; // StringRef
+    }
+    if (kind < 70)
+    {
+        return 4 + trace_rand(state, 28); // Texts: modes, numbers, IP addresses
+    }
+    if (kind < 80)
+    {
+        return 24; // WatchListNode
+    }
+    if (kind < 90)
+    {
+        return 40 + trace_rand(state, 88); // ArrayValue
+    }
+    if (kind < 98)
+    {
+        return 48 + trace_rand(state, 208); // Component execution states
+    }
+    return 257 + trace_rand(state, 768); // Larger than any size class
+}
+
+// Fill a block with a pattern of its slot, to catch blocks handed out twice
+static void fill_block(const alloc_bench_slot_t *slot, uint32_t index)
+{
+    memset(slot->ptr, (uint8_t)(index * 31 + 7), slot->size);
+}
+
+static bool check_block(const alloc_bench_slot_t *slot, uint32_t index)
+{
+    const uint8_t *bytes = (const uint8_t *)slot->ptr;
+    for (uint32_t i = 0; i < slot->size; i++)
+    {
+        if (bytes[i] != (uint8_t)(index * 31 + 7))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Run `ops` allocations and frees of the trace through `path`, returns the elapsed seconds or a negative value
+// if a block was corrupted. `live_bytes` is set to the bytes requested by the blocks still alive at the end.
+static double run_trace(const alloc_bench_path_t *path, uint32_t ops, bool check, uint64_t *live_bytes)
+{
+    uint32_t state = 12345;
+    const double start = now_s();
+    for (uint32_t op = 0; op < ops; op++)
+    {
+        const uint32_t index = trace_rand(&state, ALLOC_BENCH_SLOTS);
+        alloc_bench_slot_t *slot = &slots[index];
+        if (slot->ptr)
+        {
+            if (check && !check_block(slot, index))
+            {
+                return -1;
+            }
+            path->free(slot->ptr);
+            slot->ptr = NULL;
+        }
+        else
+        {
+            slot->size = trace_size(&state);
+            slot->ptr = path->alloc(slot->size);
+            if (!slot->ptr)
+            {
+                return -1;
+            }
+            if (check)
+            {
+                fill_block(slot, index);
+            }
+        }
+    }
+    const double elapsed = now_s() - start;
+
+    *live_bytes = 0;
+    for (uint32_t i = 0; i < ALLOC_BENCH_SLOTS; i++)
+    {
+        *live_bytes += slots[i].ptr ? slots[i].size : 0;
+    }
+    return elapsed;
+}
+
+static void free_all(const alloc_bench_path_t *path)
+{
+    for (uint32_t i = 0; i < ALLOC_BENCH_SLOTS; i++)
+    {
+        path->free(slots[i].ptr);
+        slots[i].ptr = NULL;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t ops = (argc > 1) ? strtoul(argv[1], NULL, 0) : ALLOC_BENCH_DEFAULT_OPS;
+    static const alloc_bench_path_t slab = {"slab", slab_alloc, slab_free};
+    static const alloc_bench_path_t heap = {"lv_mem", heap_alloc, heap_free};
+    uint64_t live_bytes;
+
+    /* Correctness: no block is handed out twice or overwritten by the allocator */
+    if (run_trace(&slab, ops / 10, true, &live_bytes) < 0)
+    {
+        fprintf(stderr, "alloc_bench: a slab block was corrupted\n");
+        return EXIT_FAILURE;
+    }
+    free_all(&slab);
+
+    /* Throughput, on the same trace */
+    const double slab_s = run_trace(&slab, ops, false, &live_bytes);
+    eez_alloc_stats_t stats;
+    eez_flow_get_alloc_stats(&stats);
+    free_all(&slab);
+
+    const struct mallinfo2 heap_before = mallinfo2();
+    const double heap_s = run_trace(&heap, ops, false, &live_bytes);
+    const struct mallinfo2 heap_after = mallinfo2();
+    if (slab_s < 0 || heap_s < 0)
+    {
+        fprintf(stderr, "alloc_bench: an allocation failed\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-10s %12s %12s\n", "path", "Mops/s", "ns/op");
+    printf("%-10s %12.2f %12.1f\n", slab.name, ops / slab_s * 1e-6, slab_s * 1e9 / ops);
+    printf("%-10s %12.2f %12.1f\n", heap.name, ops / heap_s * 1e-6, heap_s * 1e9 / ops);
+
+    /* Memory held for the same live blocks at the end of the trace: the slabs' carved pages are never returned,
+       blocks the classes don't use are their fragmentation */
+    uint64_t slab_used = 0;
+    printf("-- size classes --\n");
+    printf("%-10s %8s %8s %8s %10s\n", "block", "blocks", "used", "peak", "occupancy");
+    for (int i = 0; i < EEZ_ALLOC_SIZE_CLASSES; i++)
+    {
+        const eez_alloc_class_stats_t *c = &stats.classes[i];
+        printf("%-10u %8u %8u %8u %9.0f%%\n", c->block_size, c->blocks, c->used, c->peak,
+               c->blocks ? 100.0 * c->used / c->blocks : 0.0);
+        slab_used += (uint64_t)c->used * c->block_size;
+    }
+    printf("%-20s %u of %u\n", "arena bytes carved", stats.arena_used, stats.arena_size);
+    printf("%-20s %u of %u, %u alive\n", "heap fallbacks", stats.heap_allocs, stats.allocs, stats.heap_blocks);
+    printf("-- bytes held for %llu live bytes --\n", (unsigned long long)live_bytes);
+    printf("%-20s %llu in blocks of %u carved, %.0f%% unused, plus the heap fallbacks\n", slab.name,
+           (unsigned long long)slab_used, stats.arena_used, stats.arena_used ? 100.0 - 100.0 * slab_used / stats.arena_used : 0.0);
+    printf("%-20s %llu in heap chunks, the allocator's caches included\n", heap.name, (unsigned long long)(heap_after.uordblks - heap_before.uordblks));
+    free_all(&heap);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+/*
+ * Invalidation patterns of the main screen, run through the dirty area tracking of the direct-mode rotated
+ * flush. For each pattern the bytes and areas copied into the back frame buffer are reported for the original
+ * scheme and for the coalescing engine in lvgl_port_dirty.c, which is checked to copy every area of the last
+ * two frames.
+ *
+ * Usage: dirty_corpus
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lvgl_port_dirty.h"
+
+#define DIRTY_CORPUS_HOR_RES (800)
+#define DIRTY_CORPUS_VER_RES (480)
+#define DIRTY_CORPUS_FRAME_AREAS (8) // Most unjoined areas in one frame of the corpus
+#define DIRTY_CORPUS_LOOPS (10)      // Times every pattern is repeated
+
+// Unjoined areas LVGL hands to the flush of one frame, frames where nothing is invalidated aren't flushed
+typedef struct
+{
+    uint8_t n;
+    lv_area_t areas[DIRTY_CORPUS_FRAME_AREAS];
+} dirty_corpus_frame_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t n;
+    const dirty_corpus_frame_t *frames;
+} dirty_corpus_pattern_t;
+
+// Areas of the main screen, in LVGL's unrotated coordinates
+#define AREA_FULL {0, 0, DIRTY_CORPUS_HOR_RES - 1, DIRTY_CORPUS_VER_RES - 1}
+#define AREA_AC_ARC_A {700, 262, 733, 301}      // Sector of the AC watts arc between two nearby values
+#define AREA_AC_ARC_B {716, 292, 739, 340}      // The next sector along
+#define AREA_AC_LABEL {610, 327, 672, 362}      // AC watts value
+#define AREA_PV_ARC_A {90, 170, 130, 231}       // Sector of the PV power arc
+#define AREA_PV_ARC_B {80, 222, 112, 290}       // The next sector along
+#define AREA_SOLAR_LABEL {215, 440, 285, 465}   // Solar watts value
+#define AREA_SOC_ARC {300, 150, 345, 190}       // Sector of the state of charge arc
+#define AREA_SOC_LABEL {210, 200, 290, 245}     // State of charge value
+#define AREA_BATT_VOLT {170, 280, 240, 300}     // Battery volts
+#define AREA_BATT_AMP {260, 280, 330, 300}      // Battery amps
+#define AREA_INV_MODE {540, 60, 700, 80}        // Inverter mode text
+
+static const dirty_corpus_frame_t ac_watts[] = {
+    {2, {AREA_AC_ARC_A, AREA_AC_LABEL}},
+    {1, {AREA_AC_LABEL}},
+    {2, {AREA_AC_ARC_B, AREA_AC_LABEL}},
+};
+
+static const dirty_corpus_frame_t battery[] = {
+    {2, {AREA_BATT_VOLT, AREA_BATT_AMP}},
+    {1, {AREA_BATT_AMP}},
+    {4, {AREA_SOC_ARC, AREA_SOC_LABEL, AREA_BATT_VOLT, AREA_BATT_AMP}},
+};
+
+static const dirty_corpus_frame_t all_values[] = {
+    {7, {AREA_AC_ARC_A, AREA_AC_LABEL, AREA_PV_ARC_A, AREA_SOLAR_LABEL, AREA_SOC_LABEL, AREA_BATT_VOLT, AREA_BATT_AMP}},
+    {6, {AREA_AC_ARC_B, AREA_AC_LABEL, AREA_PV_ARC_B, AREA_SOLAR_LABEL, AREA_BATT_VOLT, AREA_BATT_AMP}},
+};
+
+static const dirty_corpus_frame_t mode_change[] = {
+    {1, {AREA_INV_MODE}},
+    {3, {AREA_AC_ARC_A, AREA_AC_LABEL, AREA_INV_MODE}},
+    {1, {AREA_AC_LABEL}},
+};
+
+static const dirty_corpus_frame_t screen_load[] = {
+    {1, {AREA_FULL}},
+    {2, {AREA_AC_ARC_A, AREA_AC_LABEL}},
+    {3, {AREA_PV_ARC_A, AREA_SOLAR_LABEL, AREA_BATT_AMP}},
+};
+
+#define PATTERN(frames) {#frames, sizeof(frames) / sizeof(frames[0]), frames}
+
+static const dirty_corpus_pattern_t patterns[] = {
+    PATTERN(ac_watts),
+    PATTERN(battery),
+    PATTERN(all_values),
+    PATTERN(mode_change),
+    PATTERN(screen_load),
+};
+
+typedef struct
+{
+    uint64_t bytes; // Bytes copied into the back frame buffer
+    uint32_t areas; // Copies made
+} dirty_corpus_cost_t;
+
+static uint32_t frame_size(const dirty_corpus_frame_t *frame)
+{
+    uint32_t size = 0;
+    for (int i = 0; i < frame->n; i++)
+    {
+        size += lv_area_get_size(&frame->areas[i]);
+    }
+    return size;
+}
+
+static bool frame_is_full(const dirty_corpus_frame_t *frame)
+{
+    return frame->n == 1 && lv_area_get_size(&frame->areas[0]) == DIRTY_CORPUS_HOR_RES * DIRTY_CORPUS_VER_RES;
+}
+
+/*
+ * The original flush copied a frame's areas into the next frame buffer and, after the vsync, the same areas into
+ * the other one. A partial frame following a full one went through a forced full refresh, copying the whole
+ * screen plus the partial areas (and rendering the screen once more, which isn't counted here).
+ */
+static void run_original(const dirty_corpus_frame_t *frame, bool *prev_full, dirty_corpus_cost_t *cost)
+{
+    const bool full = frame_is_full(frame);
+    if (*prev_full && !full)
+    {
+        cost->bytes += (DIRTY_CORPUS_HOR_RES * DIRTY_CORPUS_VER_RES + frame_size(frame)) * sizeof(uint16_t);
+        cost->areas += 1 + frame->n;
+    }
+    else if (*prev_full && full)
+    {
+        cost->bytes += DIRTY_CORPUS_HOR_RES * DIRTY_CORPUS_VER_RES * sizeof(uint16_t);
+        cost->areas += 1;
+    }
+    else
+    {
+        cost->bytes += 2 * frame_size(frame) * sizeof(uint16_t);
+        cost->areas += 2 * frame->n;
+    }
+    *prev_full = full;
+}
+
+static uint8_t copied[DIRTY_CORPUS_VER_RES][DIRTY_CORPUS_HOR_RES]; // Pixels copied in a frame
+
+// Mark or check the pixels of `area` in `copied`, returns whether all of them were marked
+static bool copied_area(const lv_area_t *area, bool mark)
+{
+    for (int y = area->y1; y <= area->y2; y++)
+    {
+        for (int x = area->x1; x <= area->x2; x++)
+        {
+            if (mark)
+            {
+                copied[y][x] = 1;
+            }
+            else if (!copied[y][x])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * The flush now copies the union of the last two frames' areas into the frame buffer shown two frames ago.
+ * Returns whether that union covered both frames' areas.
+ */
+static bool run_engine(const dirty_corpus_frame_t *frame, const dirty_corpus_frame_t *prev_frame, lv_disp_t *disp, lv_port_dirty_area_t *dirty_area, dirty_corpus_cost_t *cost)
+{
+    disp->inv_p = frame->n;
+    memcpy(disp->inv_areas, frame->areas, frame->n * sizeof(lv_area_t));
+    memset(disp->inv_area_joined, 0, sizeof(disp->inv_area_joined));
+
+    lv_port_dirty_area_t dirty_copy_area = *dirty_area;
+    lvgl_port_dirty_save(dirty_area, disp);
+    lvgl_port_dirty_merge(&dirty_copy_area, dirty_area, DIRTY_CORPUS_HOR_RES, DIRTY_CORPUS_VER_RES);
+    cost->bytes += lvgl_port_dirty_get_size(&dirty_copy_area) * sizeof(uint16_t);
+    cost->areas += dirty_copy_area.inv_p;
+
+    memset(copied, 0, sizeof(copied));
+    for (int i = 0; i < dirty_copy_area.inv_p; i++)
+    {
+        copied_area(&dirty_copy_area.inv_areas[i], true);
+    }
+    for (int i = 0; i < frame->n; i++)
+    {
+        if (!copied_area(&frame->areas[i], false))
+        {
+            return false;
+        }
+    }
+    for (int i = 0; prev_frame != NULL && i < prev_frame->n; i++)
+    {
+        if (!copied_area(&prev_frame->areas[i], false))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    lv_disp_drv_t drv = {.hor_res = DIRTY_CORPUS_HOR_RES, .ver_res = DIRTY_CORPUS_VER_RES};
+    lv_disp_t disp = {.driver = &drv};
+    dirty_corpus_cost_t total_original = {0};
+    dirty_corpus_cost_t total_engine = {0};
+
+    printf("%-12s %6s %12s %12s %12s %12s\n", "pattern", "frames", "bytes before", "bytes after", "areas before", "areas after");
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+    {
+        dirty_corpus_cost_t original = {0};
+        dirty_corpus_cost_t engine = {0};
+        bool prev_full = false;
+        const dirty_corpus_frame_t *prev_frame = NULL;
+        lv_port_dirty_area_t dirty_area = {.inv_p = 0}; // Both frame buffers start out in sync
+
+        for (int loop = 0; loop < DIRTY_CORPUS_LOOPS; loop++)
+        {
+            for (int f = 0; f < patterns[p].n; f++)
+            {
+                const dirty_corpus_frame_t *frame = &patterns[p].frames[f];
+                run_original(frame, &prev_full, &original);
+                if (!run_engine(frame, prev_frame, &disp, &dirty_area, &engine))
+                {
+                    fprintf(stderr, "dirty_corpus: frame %d of %s isn't fully copied\n", f, patterns[p].name);
+                    return EXIT_FAILURE;
+                }
+                prev_frame = frame;
+            }
+        }
+        printf("%-12s %6u %12llu %12llu %12u %12u\n", patterns[p].name, patterns[p].n * DIRTY_CORPUS_LOOPS,
+               (unsigned long long)original.bytes, (unsigned long long)engine.bytes, original.areas, engine.areas);
+        total_original.bytes += original.bytes;
+        total_original.areas += original.areas;
+        total_engine.bytes += engine.bytes;
+        total_engine.areas += engine.areas;
+    }
+    printf("%-12s %6s %12llu %12llu %12u %12u\n", "total", "", (unsigned long long)total_original.bytes,
+           (unsigned long long)total_engine.bytes, total_original.areas, total_engine.areas);
+    return EXIT_SUCCESS;
+}
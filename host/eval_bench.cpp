@@ -0,0 +1,191 @@
+/*
+ * Benchmark of the flow's expression evaluator: every property of every flow of the UI's assets is evaluated,
+ * as the screens' tick does, through the expressions predecoded when the flow starts and through the bytecode
+ * interpreter, with the predecoded expressions freed. The time per evaluation of each is reported, best of a
+ * number of passes alternating between the two. A first pass checks that both give every property the same value.
+ *
+ * Usage: eval_bench [iterations]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "eez-flow.h"
+#include "ui.h"
+#include "vars.h"
+
+#define EVAL_BENCH_DEFAULT_ITERATIONS (20000)
+#define EVAL_BENCH_PASSES (30)
+#define EVAL_BENCH_MAX_FLOWS (8)
+#define EVAL_BENCH_TEXT_SIZE (64)
+
+using namespace eez;
+using namespace eez::flow;
+
+namespace eez {
+namespace flow {
+FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex);
+}
+}
+
+static FlowState *bench_flows[EVAL_BENCH_MAX_FLOWS];
+static uint32_t bench_num_flows = 0;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Publish the values the firmware publishes before `ui_init()` and a set of readings
+static void bench_publish(void)
+{
+    native_var_publish_bool(NATIVE_VAR_INV_SWITCH, true);
+    native_var_publish_int(NATIVE_VAR_BATT_TEMP, 20);
+    native_var_publish_int(NATIVE_VAR_BACKLIGHT_DELAY, 30);
+    native_var_publish_string(NATIVE_VAR_IP_ADDR, "192.168.1.20");
+    native_var_publish_code(NATIVE_VAR_INV_MODE, VICTRON_MODE_INVERTING);
+    native_var_publish_code(NATIVE_VAR_SOLAR_MODE, VICTRON_MODE_BULK);
+    native_var_publish_code(NATIVE_VAR_INV_ERROR, VICTRON_VEBUS_ERROR_NONE);
+    native_var_publish_code(NATIVE_VAR_SOLAR_ERROR, VICTRON_CHARGER_ERROR_NONE);
+    native_var_publish_code(NATIVE_VAR_BATT_ALARM, 0);
+    native_var_publish_int(NATIVE_VAR_AC_WATTS, 350);
+    native_var_publish_int(NATIVE_VAR_SOLAR_WATTS, 120);
+    native_var_publish_float(NATIVE_VAR_BATT_AMP, -15.0f);
+    native_var_publish_float(NATIVE_VAR_BATT_VOLT, 13.2f);
+    native_var_publish_float(NATIVE_VAR_BATT_SOC, 80);
+    native_var_publish_int(NATIVE_VAR_SOLAR_YIELD, 1234);
+    native_vars_refresh();
+}
+
+// Whether the property has an expression, the tick doesn't evaluate the empty ones
+static bool has_expression(const Property *property)
+{
+    const uint8_t *instructions = property->evalInstructions;
+    return (instructions[0] | (instructions[1] << 8)) != EXPR_EVAL_INSTRUCTION_TYPE_END;
+}
+
+// Evaluate every property once, writing the type and text of each to `texts` if not null. Returns the number
+// of evaluations, or -1 if one failed.
+static int32_t eval_all(char (*texts)[EVAL_BENCH_TEXT_SIZE])
+{
+    int32_t evals = 0;
+    for (uint32_t k = 0; k < bench_num_flows; k++)
+    {
+        FlowState *flowState = bench_flows[k];
+        for (uint32_t c = 0; c < flowState->flow->components.count; c++)
+        {
+            Component *component = flowState->flow->components[c];
+            for (uint32_t p = 0; p < component->properties.count; p++)
+            {
+                if (!has_expression(component->properties[p]))
+                {
+                    continue;
+                }
+                Value value;
+                if (!evalProperty(flowState, c, p, value, FlowError::Property("eval_bench", "property")))
+                {
+                    fprintf(stderr, "eval_bench: flow %u component %u property %u failed\n", k, c, p);
+                    return -1;
+                }
+                if (texts)
+                {
+                    char text[EVAL_BENCH_TEXT_SIZE - 8] = "";
+                    value.toText(text, sizeof(text));
+                    snprintf(texts[evals], EVAL_BENCH_TEXT_SIZE, "%d:%s", (int)value.getType(), text);
+                }
+                evals++;
+            }
+        }
+    }
+    return evals;
+}
+
+// Time of `iterations` evaluations of every property, in ns per evaluation
+static double time_evals(uint32_t iterations, int32_t evals)
+{
+    const double start_s = now_s();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        eval_all(nullptr);
+    }
+    return (now_s() - start_s) * 1e9 / ((double)iterations * evals);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : EVAL_BENCH_DEFAULT_ITERATIONS;
+
+    /* The flow as `eez_flow_init()` starts it, without the screens */
+    bench_publish();
+    initAssetsMemory();
+    loadMainAssets(assets, sizeof(assets));
+    initOtherMemory();
+    initAllocHeap(ALLOC_BUFFER, ALLOC_BUFFER_SIZE);
+    start(g_mainAssets);
+    FlowDefinition *flowDefinition = static_cast<FlowDefinition *>(g_mainAssets->flowDefinition);
+    bench_num_flows = flowDefinition->flows.count;
+    if (bench_num_flows > EVAL_BENCH_MAX_FLOWS)
+    {
+        fprintf(stderr, "eval_bench: %u flows, at most %d supported\n", bench_num_flows, EVAL_BENCH_MAX_FLOWS);
+        return EXIT_FAILURE;
+    }
+    for (uint32_t k = 0; k < bench_num_flows; k++)
+    {
+        bench_flows[k] = initPageFlowState(g_mainAssets, k, nullptr, 0);
+    }
+
+    /* Correctness: the predecoded expressions give the interpreter's values */
+    const int32_t evals = eval_all(nullptr);
+    if (evals <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+    char (*decoded_texts)[EVAL_BENCH_TEXT_SIZE] = (char (*)[EVAL_BENCH_TEXT_SIZE])::malloc(2 * evals * EVAL_BENCH_TEXT_SIZE);
+    if (!decoded_texts)
+    {
+        return EXIT_FAILURE;
+    }
+    char (*interp_texts)[EVAL_BENCH_TEXT_SIZE] = decoded_texts + evals;
+    eval_all(decoded_texts);
+    freeDecodedExpressions();
+    eval_all(interp_texts);
+    int mismatches = 0;
+    for (int32_t i = 0; i < evals; i++)
+    {
+        if (strcmp(decoded_texts[i], interp_texts[i]) != 0)
+        {
+            fprintf(stderr, "eval_bench: evaluation %d gave '%s' predecoded, '%s' interpreted\n", (int)i, decoded_texts[i], interp_texts[i]);
+            mismatches++;
+        }
+    }
+    ::free(decoded_texts);
+    if (mismatches)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Throughput, the best of passes alternating between the two */
+    double decoded_ns = 0;
+    double interp_ns = 0;
+    for (int pass = 0; pass < EVAL_BENCH_PASSES; pass++)
+    {
+        decodeExpressions(g_mainAssets);
+        const double pass_decoded_ns = time_evals(iterations, evals);
+        freeDecodedExpressions();
+        const double pass_interp_ns = time_evals(iterations, evals);
+        decoded_ns = (pass == 0 || pass_decoded_ns < decoded_ns) ? pass_decoded_ns : decoded_ns;
+        interp_ns = (pass == 0 || pass_interp_ns < interp_ns) ? pass_interp_ns : interp_ns;
+    }
+
+    printf("-- flow expressions --\n");
+    printf("%-20s %d\n", "properties", (int)evals);
+    printf("%-20s %u\n", "iterations", iterations);
+    printf("%-20s %.1f\n", "ns/eval predecoded", decoded_ns);
+    printf("%-20s %.1f\n", "ns/eval interpreted", interp_ns);
+    return EXIT_SUCCESS;
+}
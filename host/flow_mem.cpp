@@ -0,0 +1,74 @@
+/*
+ * Memory the flow keeps for the UI: the sizes of the flow's value and state types, and the bytes requested from
+ * the flow allocator by starting the flow on the UI's assets and by the flow state of each page, as the delta of
+ * `eez_alloc_stats_t::alloc_bytes`. The host is LP64, the sizes of the types holding pointers are larger than on
+ * the ESP32.
+ *
+ * Usage: flow_mem
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eez-flow.h"
+#include "ui.h"
+
+using namespace eez;
+using namespace eez::flow;
+
+namespace eez {
+namespace flow {
+FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex);
+}
+}
+
+// Bytes requested from the flow allocator since `start`
+static uint32_t alloc_bytes_since(const eez_alloc_stats_t *start)
+{
+    eez_alloc_stats_t stats;
+    eez_flow_get_alloc_stats(&stats);
+    return stats.alloc_bytes - start->alloc_bytes;
+}
+
+int main(void)
+{
+    printf("-- flow types --\n");
+    printf("%-20s %u\n", "Value", (unsigned)sizeof(Value));
+    printf("%-20s %u\n", "EvalStack", (unsigned)sizeof(EvalStack));
+    printf("%-20s %u\n", "FlowState", (unsigned)sizeof(FlowState));
+
+    /* The flow as `eez_flow_init()` starts it, without the screens */
+    eez_alloc_stats_t start_stats;
+    eez_flow_get_alloc_stats(&start_stats);
+    initAssetsMemory();
+    loadMainAssets(assets, sizeof(assets));
+    initOtherMemory();
+    initAllocHeap(ALLOC_BUFFER, ALLOC_BUFFER_SIZE);
+    start(g_mainAssets);
+    const uint32_t start_bytes = alloc_bytes_since(&start_stats);
+
+    printf("-- flow allocations --\n");
+    printf("%-20s %u\n", "start", start_bytes);
+    FlowDefinition *flowDefinition = static_cast<FlowDefinition *>(g_mainAssets->flowDefinition);
+    uint32_t total = 0;
+    for (uint32_t k = 0; k < flowDefinition->flows.count; k++)
+    {
+        Flow *flow = flowDefinition->flows[k];
+        eez_alloc_stats_t page_stats;
+        eez_flow_get_alloc_stats(&page_stats);
+        if (!initPageFlowState(g_mainAssets, k, nullptr, 0))
+        {
+            fprintf(stderr, "flow_mem: the flow state of flow %u could not be allocated\n", k);
+            return EXIT_FAILURE;
+        }
+        const uint32_t bytes = alloc_bytes_since(&page_stats);
+        char name[32];
+        snprintf(name, sizeof(name), "flow %u", k);
+        printf("%-20s %u (%u components, %u inputs, %u locals)\n", name, bytes, (unsigned)flow->components.count,
+               (unsigned)flow->componentInputs.count, (unsigned)flow->localVariables.count);
+        total += bytes;
+    }
+    printf("%-20s %u\n", "flow states", total);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,26 @@
+/*
+ * LVGL configuration of the host build, the CONFIG_LV_* settings of sdkconfig.defaults.
+ * Everything else keeps the LVGL 8.4 defaults, as in the firmware.
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_SCREEN_TRANSP 1
+
+#define LV_MEM_CUSTOM 1
+#define LV_MEMCPY_MEMSET_STD 1
+
+#define LV_USE_LOG 1
+#define LV_LOG_PRINTF 1
+#define LV_USE_PERF_MONITOR 0
+
+#define LV_USE_FONT_COMPRESSED 1
+#define LV_USE_IMGFONT 1
+#define LV_USE_SNAPSHOT 1
+
+#define LV_SHADOW_CACHE_SIZE 32
+#define LV_CIRCLE_CACHE_SIZE 8
+
+#endif /*LV_CONF_H*/
@@ -0,0 +1,202 @@
+/*
+ * Benchmark of the rotation copy kernels of the LVGL port: every kernel is checked against the reference
+ * per-pixel copy, then timed on areas of the sizes the main screen refreshes, and its throughput reported.
+ *
+ * Usage: rotate_bench [ms per case]
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl_port_rotate.h"
+
+#define ROTATE_BENCH_DEFAULT_MS (200)
+#define ROTATE_BENCH_W (800) // Size of the frame buffers, the panel's
+#define ROTATE_BENCH_H (480)
+#define ROTATE_BENCH_PX (ROTATE_BENCH_W * ROTATE_BENCH_H)
+#define ROTATE_BENCH_BOUNCE_PX (ROTATE_BENCH_W * 10) // Pixels of one bounce buffer
+
+typedef void (*rotate_kernel_t)(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation);
+
+typedef struct
+{
+    const char *name;
+    uint16_t x_start, y_start, x_end, y_end;
+} rotate_bench_area_t;
+
+static const rotate_bench_area_t areas[] = {
+    {"full screen", 0, 0, ROTATE_BENCH_W - 1, ROTATE_BENCH_H - 1},
+    {"half screen", 0, 0, ROTATE_BENCH_W - 1, ROTATE_BENCH_H / 2 - 1},
+    {"gauge 240x240", 40, 120, 279, 359},
+    {"label 161x48", 101, 53, 261, 100},
+    {"digit 23x33", 333, 211, 355, 243},
+};
+
+static void kernel_180(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
+{
+    lvgl_port_rotate_copy_180(from, to, x_start, y_start, x_end, y_end, w, h);
+}
+
+static uint16_t *src;
+static uint16_t *dst;
+static uint16_t *dst_ref;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Copy `area` with `kernel` until `ms` have passed, returns MPixel/s
+static double bench_kernel(rotate_kernel_t kernel, const rotate_bench_area_t *area, uint16_t rotation, uint32_t ms)
+{
+    const double px = (double)(area->x_end - area->x_start + 1) * (area->y_end - area->y_start + 1);
+    uint32_t runs = 0;
+    const double start = now_s();
+    double elapsed;
+    do
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            kernel(src, dst, area->x_start, area->y_start, area->x_end, area->y_end, ROTATE_BENCH_W, ROTATE_BENCH_H, rotation);
+        }
+        runs += 8;
+        elapsed = now_s() - start;
+    } while (elapsed * 1000 < ms);
+    return px * runs / elapsed * 1e-6;
+}
+
+// Check that `kernel` writes exactly what the reference does, inside the area and out of it
+static bool check_kernel(rotate_kernel_t kernel, const rotate_bench_area_t *area, uint16_t rotation)
+{
+    memset(dst, 0xa5, ROTATE_BENCH_PX * sizeof(uint16_t));
+    memset(dst_ref, 0xa5, ROTATE_BENCH_PX * sizeof(uint16_t));
+    lvgl_port_rotate_copy_reference(src, dst_ref, area->x_start, area->y_start, area->x_end, area->y_end, ROTATE_BENCH_W, ROTATE_BENCH_H, rotation);
+    kernel(src, dst, area->x_start, area->y_start, area->x_end, area->y_end, ROTATE_BENCH_W, ROTATE_BENCH_H, rotation);
+    return memcmp(dst, dst_ref, ROTATE_BENCH_PX * sizeof(uint16_t)) == 0;
+}
+
+// Check the row reversal on every alignment of the source and destination
+static bool check_reverse(void)
+{
+    for (int src_ofs = 0; src_ofs < 8; src_ofs++)
+    {
+        for (int dst_ofs = 0; dst_ofs < 8; dst_ofs++)
+        {
+            for (int len = 0; len < 40; len++)
+            {
+                memset(dst, 0xa5, 64 * sizeof(uint16_t));
+                memset(dst_ref, 0xa5, 64 * sizeof(uint16_t));
+                for (int i = 0; i < len; i++)
+                {
+                    dst_ref[dst_ofs + i] = src[src_ofs + len - 1 - i];
+                }
+                lvgl_port_rotate_reverse(src + src_ofs, dst + dst_ofs, len);
+                if (memcmp(dst, dst_ref, 64 * sizeof(uint16_t)) != 0)
+                {
+                    fprintf(stderr, "rotate_bench: reverse of %d pixels from +%d to +%d differs\n", len, src_ofs, dst_ofs);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Fill a bounce buffer the way the scan-out rotation does, returns MPixel/s
+static double bench_bounce(bool reference, uint32_t ms)
+{
+    uint32_t runs = 0;
+    const double start = now_s();
+    double elapsed;
+    do
+    {
+        for (int pos = 0; pos < ROTATE_BENCH_PX; pos += ROTATE_BENCH_BOUNCE_PX)
+        {
+            const uint16_t *from = src + ROTATE_BENCH_PX - pos - ROTATE_BENCH_BOUNCE_PX;
+            if (reference)
+            {
+                for (int i = 0; i < ROTATE_BENCH_BOUNCE_PX; i++)
+                {
+                    dst[i] = from[ROTATE_BENCH_BOUNCE_PX - 1 - i];
+                }
+            }
+            else
+            {
+                lvgl_port_rotate_reverse(from, dst, ROTATE_BENCH_BOUNCE_PX);
+            }
+        }
+        runs++;
+        elapsed = now_s() - start;
+    } while (elapsed * 1000 < ms);
+    return (double)ROTATE_BENCH_PX * runs / elapsed * 1e-6;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t ms = (argc > 1) ? strtoul(argv[1], NULL, 0) : ROTATE_BENCH_DEFAULT_MS;
+
+    // Frame buffers are 64-byte aligned, like the RGB panel's
+    src = aligned_alloc(64, ROTATE_BENCH_PX * sizeof(uint16_t));
+    dst = aligned_alloc(64, ROTATE_BENCH_PX * sizeof(uint16_t));
+    dst_ref = aligned_alloc(64, ROTATE_BENCH_PX * sizeof(uint16_t));
+    if (src == NULL || dst == NULL || dst_ref == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    uint32_t seed = 12345;
+    for (int i = 0; i < ROTATE_BENCH_PX; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        src[i] = seed >> 16;
+    }
+
+    static const struct
+    {
+        uint16_t rotation;
+        rotate_kernel_t kernel;
+    } kernels[] = {
+        {90, lvgl_port_rotate_copy_tiled},
+        {180, kernel_180},
+        {270, lvgl_port_rotate_copy_tiled},
+    };
+
+    if (!check_reverse())
+    {
+        return EXIT_FAILURE;
+    }
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        for (size_t a = 0; a < sizeof(areas) / sizeof(areas[0]); a++)
+        {
+            if (!check_kernel(kernels[k].kernel, &areas[a], kernels[k].rotation))
+            {
+                fprintf(stderr, "rotate_bench: %u degree copy of the %s area differs from the reference\n", kernels[k].rotation, areas[a].name);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    printf("%-8s %-16s %12s %12s %8s\n", "rotation", "area", "reference", "blocked", "speedup");
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        for (size_t a = 0; a < sizeof(areas) / sizeof(areas[0]); a++)
+        {
+            const double reference = bench_kernel(lvgl_port_rotate_copy_reference, &areas[a], kernels[k].rotation, ms);
+            const double blocked = bench_kernel(kernels[k].kernel, &areas[a], kernels[k].rotation, ms);
+            printf("%-8u %-16s %8.1f MP/s %8.1f MP/s %7.2fx\n", kernels[k].rotation, areas[a].name, reference, blocked, blocked / reference);
+        }
+    }
+    const double reference = bench_bounce(true, ms);
+    const double blocked = bench_bounce(false, ms);
+    printf("%-8s %-16s %8.1f MP/s %8.1f MP/s %7.2fx\n", "scan-out", "bounce buffer", reference, blocked, blocked / reference);
+
+    free(src);
+    free(dst);
+    free(dst_ref);
+    return EXIT_SUCCESS;
+}
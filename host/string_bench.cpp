@@ -0,0 +1,202 @@
+/*
+ * Benchmark of the strings the flow builds: each tick runs the string operations an action formatting the
+ * readings of ui_bench's script would evaluate (a number plus a unit, String.format, a substring of the IP
+ * address, a mode text plus a suffix) through the flow's own operations on an eval stack. The flow allocations
+ * per tick and the time per tick are reported. A first pass checks every string against the expected text.
+ *
+ * string_bench_no_inline is the same with EEZ_FOR_LVGL_STRING_INLINE_OPTION off, every string in a StringRef.
+ *
+ * Usage: string_bench [ticks]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "eez-flow.h"
+
+#define STRING_BENCH_DEFAULT_TICKS (200000)
+
+using namespace eez;
+using namespace eez::flow;
+using namespace eez::flow::defs_v3;
+
+static EvalStack bench_stack;
+static uint32_t bench_strings = 0; // Strings built
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Blocks the flow allocator has handed out and not taken back
+static uint32_t live_blocks(const eez_alloc_stats_t *stats)
+{
+    uint32_t blocks = stats->heap_blocks;
+    for (int i = 0; i < EEZ_ALLOC_SIZE_CLASSES; i++)
+    {
+        blocks += stats->classes[i].used;
+    }
+    return blocks;
+}
+
+// Deterministic pseudo-random number in [0, n)
+static uint32_t script_rand(uint32_t n)
+{
+    static uint32_t state = 12345;
+    state = state * 1664525 + 1013904223;
+    return (state >> 8) % n;
+}
+
+// Walk `value` by up to `step` in either direction, within [min, max]
+static int32_t script_walk(int32_t value, int32_t step, int32_t min, int32_t max)
+{
+    value += (int32_t)script_rand(2 * step + 1) - step;
+    return value < min ? min : (value > max ? max : value);
+}
+
+// Run `operation` on the stack, which leaves its string there, and check it against `expected` if not null
+static bool run_operation(OperationTypes operation, const char *expected)
+{
+    g_evalOperations[operation](bench_stack);
+    bench_strings++;
+    if (!expected)
+    {
+        return true;
+    }
+    const Value *result = bench_stack.sp > 0 ? &bench_stack.stack[bench_stack.sp - 1] : nullptr;
+    const char *str = (result && result->isString()) ? result->getString() : nullptr;
+    if (!str || strcmp(str, expected) != 0)
+    {
+        fprintf(stderr, "string_bench: operation %d gave '%s', expected '%s'\n", (int)operation, str ? str : "(none)", expected);
+        return false;
+    }
+    return true;
+}
+
+// Evaluate the strings of one tick, checked against the expected text if `check`, the stack is left empty
+static bool run_tick(int32_t ac_watts, int32_t solar_watts, int32_t batt_soc, float batt_volt, const char *inv_mode, const char *ip_addr, bool check)
+{
+    char expected[8][32];
+    if (check)
+    {
+        snprintf(expected[0], sizeof(expected[0]), "%d W", (int)ac_watts);
+        snprintf(expected[1], sizeof(expected[1]), "%d W", (int)solar_watts);
+        snprintf(expected[2], sizeof(expected[2]), "%.2f", batt_volt);
+        snprintf(expected[3], sizeof(expected[3]), "%.2f V", batt_volt);
+        snprintf(expected[4], sizeof(expected[4]), "SOC %d", (int)batt_soc);
+        snprintf(expected[5], sizeof(expected[5]), "SOC %d%%", (int)batt_soc);
+        snprintf(expected[6], sizeof(expected[6]), "%s mode", inv_mode);
+        snprintf(expected[7], sizeof(expected[7]), "%.7s", ip_addr);
+    }
+#define EXPECTED(n) (check ? expected[n] : nullptr)
+    bool ok = true;
+
+    /* ac_watts + " W", solar_watts + " W" */
+    bench_stack.push(Value((int)ac_watts, VALUE_TYPE_INT32));
+    bench_stack.push(Value(" W", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(0));
+    bench_stack.push(Value((int)solar_watts, VALUE_TYPE_INT32));
+    bench_stack.push(Value(" W", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(1));
+
+    /* String.format("%.2f", batt_volt) + " V" */
+    bench_stack.push(Value(batt_volt, VALUE_TYPE_FLOAT));
+    bench_stack.push(Value("%.2f", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_STRING_FORMAT, EXPECTED(2));
+    bench_stack.push(Value(" V", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(3));
+
+    /* "SOC " + batt_soc + "%" */
+    bench_stack.push(Value("SOC ", VALUE_TYPE_STRING));
+    bench_stack.push(Value((int)batt_soc, VALUE_TYPE_INT32));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(4));
+    bench_stack.push(Value("%", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(5));
+
+    /* inv_mode + " mode" */
+    bench_stack.push(Value(inv_mode, VALUE_TYPE_STRING));
+    bench_stack.push(Value(" mode", VALUE_TYPE_STRING));
+    ok = ok && run_operation(OPERATION_TYPE_ADD, EXPECTED(6));
+
+    /* String.substring(ip_addr, 0, 7) */
+    bench_stack.push(Value(7, VALUE_TYPE_INT32));
+    bench_stack.push(Value(0, VALUE_TYPE_INT32));
+    bench_stack.push(Value(ip_addr, VALUE_TYPE_STRING));
+    bench_stack.push(Value(3, VALUE_TYPE_INT32));
+    ok = ok && run_operation(OPERATION_TYPE_STRING_SUBSTRING, EXPECTED(7));
+#undef EXPECTED
+
+    while (bench_stack.sp > 0)
+    {
+        bench_stack.pop();
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t ticks = (argc > 1) ? strtoul(argv[1], NULL, 0) : STRING_BENCH_DEFAULT_TICKS;
+    static const char *inv_modes[] = {"Inverting", "Low power", "Assisting", "Off"};
+    int32_t ac_watts = 350;
+    int32_t solar_watts = 120;
+    int32_t batt_soc = 80;
+    int32_t batt_centivolts = 1320;
+    bench_stack.flowState = nullptr;
+    bench_stack.componentIndex = 0;
+
+    /* The readings of every tick, so the timed pass only builds the strings */
+    int32_t *readings = (int32_t *)::malloc(ticks * 4 * sizeof(int32_t));
+    if (!readings)
+    {
+        return EXIT_FAILURE;
+    }
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        readings[tick * 4] = ac_watts = script_walk(ac_watts, 40, 0, 3000);
+        readings[tick * 4 + 1] = solar_watts = script_walk(solar_watts, 15, 0, 400);
+        readings[tick * 4 + 2] = batt_soc = script_walk(batt_soc, 1, 0, 100);
+        readings[tick * 4 + 3] = batt_centivolts = script_walk(batt_centivolts, 2, 1150, 1460);
+    }
+
+    eez_alloc_stats_t start;
+    eez_flow_get_alloc_stats(&start);
+    double elapsed = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const bool check = (pass == 0);
+        const double start_s = now_s();
+        for (uint32_t tick = 0; tick < ticks; tick++)
+        {
+            const int32_t *r = &readings[tick * 4];
+            if (!run_tick(r[0], r[1], r[2], r[3] / 100.0f, inv_modes[tick / 50 % 4], "192.168.1.20", check))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        elapsed = now_s() - start_s;
+    }
+    ::free(readings);
+    for (size_t i = 0; i < STACK_SIZE; i++)
+    {
+        bench_stack.stack[i] = Value(); // A popped slot keeps its value until it's pushed over
+    }
+    eez_alloc_stats_t stats;
+    eez_flow_get_alloc_stats(&stats);
+    if (live_blocks(&stats) != live_blocks(&start))
+    {
+        fprintf(stderr, "string_bench: %d blocks were not freed\n", (int)(live_blocks(&stats) - live_blocks(&start)));
+        return EXIT_FAILURE;
+    }
+
+    printf("-- flow strings, %s --\n", EEZ_FOR_LVGL_STRING_INLINE_OPTION ? "inline strings" : "StringRefs only");
+    printf("%-20s %u\n", "ticks", ticks);
+    printf("%-20s %.0f\n", "strings/tick", (double)bench_strings / (2 * ticks));
+    printf("%-20s %.2f\n", "allocs/tick", (double)(stats.allocs - start.allocs) / (2 * ticks));
+    printf("%-20s %.1f\n", "ns/tick", elapsed * 1e9 / ticks);
+    return EXIT_SUCCESS;
+}
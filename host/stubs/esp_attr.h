@@ -0,0 +1,6 @@
+#pragma once
+
+// Code and data placement has no meaning on the host
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_BSS_ATTR
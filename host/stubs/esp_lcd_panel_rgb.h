@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+} esp_lcd_rgb_panel_event_data_t;
+
+typedef bool (*esp_lcd_rgb_panel_vsync_cb_t)(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx);
+typedef bool (*esp_lcd_rgb_panel_bounce_buf_fill_cb_t)(esp_lcd_panel_handle_t panel, void *bounce_buf, int pos_px, int len_bytes, void *user_ctx);
+
+typedef struct
+{
+    esp_lcd_rgb_panel_vsync_cb_t on_vsync;                   // Called after a frame buffer has been transmitted
+    esp_lcd_rgb_panel_bounce_buf_fill_cb_t on_bounce_empty;  // Called to fill a bounce buffer
+    esp_lcd_rgb_panel_vsync_cb_t on_bounce_frame_finish;     // Called after the bounce buffers of a frame are filled
+} esp_lcd_rgb_panel_event_callbacks_t;
+
+esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_callbacks_t *callbacks, void *user_ctx);
+esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t panel, uint32_t fb_num, void **fb0, ...);
+
+#ifdef __cplusplus
+}
+#endif
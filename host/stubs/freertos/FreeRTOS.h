@@ -0,0 +1,56 @@
+/*
+ * FreeRTOS subset used by the LVGL port and the UI, implemented on POSIX threads for the host build.
+ *
+ * Tasks are threads, task notifications follow the FreeRTOS semantics (a notification without a value still
+ * wakes a task blocked in `ulTaskNotifyTake`, which then returns 0), and "ISRs" are plain function calls from
+ * the thread that emulates the peripheral.
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_attr.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef struct host_task *TaskHandle_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+
+#define configTICK_RATE_HZ (CONFIG_FREERTOS_HZ)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#define tskNO_AFFINITY (INT_MAX)
+
+#define portYIELD_FROM_ISR(x) ((void)(x)) // The notified thread runs as soon as it is signalled
+
+// Critical sections are one process-wide recursive lock, there is no scheduler to disable
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+#define taskENTER_CRITICAL(mux) pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL(mux) pthread_mutex_unlock(mux)
+#define portENTER_CRITICAL(mux) pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL(mux) pthread_mutex_unlock(mux)
+#define taskENTER_CRITICAL_ISR(mux) pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL_ISR(mux) pthread_mutex_unlock(mux)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#include "host_compat.h"
+
+#ifndef HOST_HAVE_STRLCPY
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    const size_t len = strlen(src);
+    if (size > 0)
+    {
+        const size_t n = (len < size - 1) ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
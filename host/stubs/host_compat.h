@@ -0,0 +1,21 @@
+/*
+ * Functions of newlib the host C library may lack, included in front of every host build source.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef HOST_HAVE_STRLCPY
+size_t strlcpy(char *dst, const char *src, size_t size);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+struct host_timer
+{
+    esp_timer_create_args_t args;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; // Signalled when the timer is started or stopped
+    uint64_t period_us;  // Period while running, 0 while stopped
+    uint32_t generation; // Incremented on every start and stop
+};
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void timespec_add_us(struct timespec *ts, uint64_t us)
+{
+    ts->tv_sec += us / 1000000;
+    ts->tv_nsec += (us % 1000000) * 1000;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void *timer_thread(void *arg)
+{
+    struct host_timer *timer = arg;
+    pthread_mutex_lock(&timer->lock);
+    while (1)
+    {
+        while (timer->period_us == 0)
+        {
+            pthread_cond_wait(&timer->cond, &timer->lock);
+        }
+
+        // Fire on a fixed grid from the start, like the hardware timer, until stopped or restarted
+        const uint32_t generation = timer->generation;
+        struct timespec next;
+        clock_gettime(CLOCK_MONOTONIC, &next);
+        while (timer->generation == generation)
+        {
+            timespec_add_us(&next, timer->period_us);
+            if (pthread_cond_timedwait(&timer->cond, &timer->lock, &next) != ETIMEDOUT)
+            {
+                continue; // Woken by a start or stop, the generation tells which
+            }
+            pthread_mutex_unlock(&timer->lock);
+            timer->args.callback(timer->args.arg);
+            pthread_mutex_lock(&timer->lock);
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct host_timer *timer = calloc(1, sizeof(struct host_timer));
+    if (timer == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *create_args;
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&timer->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (pthread_create(&timer->thread, NULL, timer_thread, timer) != 0)
+    {
+        free(timer);
+        return ESP_FAIL;
+    }
+    pthread_detach(timer->thread);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    if (timer == NULL || period_us == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timer->lock);
+    const bool running = (timer->period_us != 0);
+    if (!running)
+    {
+        timer->period_us = period_us;
+        timer->generation++;
+        pthread_cond_signal(&timer->cond);
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return running ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timer->lock);
+    const bool running = (timer->period_us != 0);
+    if (running)
+    {
+        timer->period_us = 0;
+        timer->generation++;
+        pthread_cond_signal(&timer->cond);
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return running ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return calloc(n, size);
+}
+
+void *heap_caps_aligned_calloc(size_t alignment, size_t n, size_t size, uint32_t caps)
+{
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, alignment, n * size) != 0)
+    {
+        return NULL;
+    }
+    memset(ptr, 0, n * size);
+    return ptr;
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return mallinfo2().fordblks; // Free bytes the C heap holds, it grows on demand
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return mallinfo2().fordblks;
+}
@@ -0,0 +1,305 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// Notification states of a task, as in FreeRTOS
+enum
+{
+    NOTIFY_NONE,
+    NOTIFY_WAITING,
+    NOTIFY_RECEIVED,
+};
+
+struct host_task
+{
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    pthread_mutex_t lock; // Protects the notification
+    pthread_cond_t cond;  // Signalled when a notification is received
+    uint32_t value;       // Notification value
+    int state;            // Notification state
+};
+
+struct host_mutex
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    TaskHandle_t holder; // Task holding the mutex, NULL if free
+    uint32_t depth;      // Number of times the holder took it
+};
+
+static __thread TaskHandle_t current_task = NULL; // Task of the calling thread, created on first use
+
+static TaskHandle_t task_alloc(TaskFunction_t fn, void *arg)
+{
+    TaskHandle_t task = calloc(1, sizeof(struct host_task));
+    if (task == NULL)
+    {
+        abort();
+    }
+    task->fn = fn;
+    task->arg = arg;
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&task->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return task;
+}
+
+// Absolute CLOCK_MONOTONIC time `ticks` from now
+static struct timespec deadline_after(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t ns = (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ);
+    ts.tv_sec += ns / 1000000000ULL;
+    ts.tv_nsec += ns % 1000000000ULL;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// Wait on `cond` until `done()` or the timeout, with `lock` held. Returns whether `done()` became true.
+#define WAIT_UNTIL(cond, lock, done, ticks)                                     \
+    ({                                                                          \
+        const struct timespec deadline_ = deadline_after(ticks);                \
+        while (!(done))                                                         \
+        {                                                                       \
+            if ((ticks) == portMAX_DELAY)                                       \
+            {                                                                   \
+                pthread_cond_wait(cond, lock);                                  \
+            }                                                                   \
+            else if ((ticks) == 0 ||                                            \
+                     pthread_cond_timedwait(cond, lock, &deadline_) == ETIMEDOUT) \
+            {                                                                   \
+                break;                                                          \
+            }                                                                   \
+        }                                                                       \
+        (done);                                                                 \
+    })
+
+static void *task_entry(void *arg)
+{
+    current_task = arg;
+    current_task->fn(current_task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id)
+{
+    TaskHandle_t task = task_alloc(fn, arg);
+    if (handle)
+    {
+        *handle = task; // Set before the task runs, as FreeRTOS does for a lower priority creator
+    }
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0)
+    {
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    if (current_task == NULL)
+    {
+        current_task = task_alloc(NULL, NULL); // A thread not created by `xTaskCreatePinnedToCore`
+    }
+    return current_task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    const struct timespec deadline = deadline_after(ticks);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+    {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (TickType_t)((uint64_t)ts.tv_sec * configTICK_RATE_HZ + ts.tv_nsec / (1000000000L / configTICK_RATE_HZ));
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    BaseType_t ret = pdPASS;
+    pthread_mutex_lock(&task->lock);
+    const int state = task->state;
+    switch (action)
+    {
+    case eSetBits:
+        task->value |= value;
+        break;
+    case eIncrement:
+        task->value++;
+        break;
+    case eSetValueWithOverwrite:
+        task->value = value;
+        break;
+    case eSetValueWithoutOverwrite:
+        if (state == NOTIFY_RECEIVED)
+        {
+            ret = pdFAIL;
+        }
+        else
+        {
+            task->value = value;
+        }
+        break;
+    case eNoAction:
+    default:
+        break;
+    }
+    task->state = NOTIFY_RECEIVED;
+    if (state == NOTIFY_WAITING)
+    {
+        pthread_cond_signal(&task->cond);
+    }
+    pthread_mutex_unlock(&task->lock);
+    return ret;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    pthread_mutex_lock(&task->lock);
+    if (task->value == 0)
+    {
+        // Block until any notification, even one that leaves the value at 0
+        task->state = NOTIFY_WAITING;
+        WAIT_UNTIL(&task->cond, &task->lock, task->state == NOTIFY_RECEIVED, ticks_to_wait);
+    }
+    const uint32_t value = task->value;
+    if (value != 0)
+    {
+        task->value = clear_on_exit ? 0 : value - 1;
+    }
+    task->state = NOTIFY_NONE;
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    pthread_mutex_lock(&task->lock);
+    if (task->state != NOTIFY_RECEIVED)
+    {
+        task->value &= ~clear_on_entry;
+        task->state = NOTIFY_WAITING;
+        WAIT_UNTIL(&task->cond, &task->lock, task->state == NOTIFY_RECEIVED, ticks_to_wait);
+    }
+    if (value)
+    {
+        *value = task->value;
+    }
+    const BaseType_t received = (task->state == NOTIFY_RECEIVED);
+    if (received)
+    {
+        task->value &= ~clear_on_exit;
+    }
+    task->state = NOTIFY_NONE;
+    pthread_mutex_unlock(&task->lock);
+    return received ? pdTRUE : pdFALSE;
+}
+
+uint32_t ulTaskNotifyValueClear(TaskHandle_t task, unsigned long bits_to_clear)
+{
+    if (task == NULL)
+    {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    pthread_mutex_lock(&task->lock);
+    const uint32_t value = task->value;
+    task->value &= ~bits_to_clear;
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken)
+    {
+        *higher_priority_task_woken = pdTRUE;
+    }
+    return xTaskNotify(task, value, action);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    xTaskNotifyFromISR(task, 0, eIncrement, higher_priority_task_woken);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    SemaphoreHandle_t mutex = calloc(1, sizeof(struct host_mutex));
+    if (mutex)
+    {
+        pthread_mutex_init(&mutex->lock, NULL);
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&mutex->cond, &attr);
+        pthread_condattr_destroy(&attr);
+    }
+    return mutex;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    pthread_mutex_lock(&mutex->lock);
+    const bool taken = WAIT_UNTIL(&mutex->cond, &mutex->lock, mutex->holder == NULL || mutex->holder == task, ticks_to_wait);
+    if (taken)
+    {
+        mutex->holder = task;
+        mutex->depth++;
+    }
+    pthread_mutex_unlock(&mutex->lock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    BaseType_t ret = pdFAIL;
+    pthread_mutex_lock(&mutex->lock);
+    if (mutex->holder == xTaskGetCurrentTaskHandle())
+    {
+        if (--mutex->depth == 0)
+        {
+            mutex->holder = NULL;
+            pthread_cond_signal(&mutex->cond);
+        }
+        ret = pdPASS;
+    }
+    pthread_mutex_unlock(&mutex->lock);
+    return ret;
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t mutex)
+{
+    pthread_mutex_lock(&mutex->lock);
+    TaskHandle_t holder = mutex->holder;
+    pthread_mutex_unlock(&mutex->lock);
+    return holder;
+}
@@ -0,0 +1,208 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_rgb.h"
+#include "host_panel.h"
+
+#define HOST_PANEL_MAX_FBS (3) // Frame buffers the RGB driver supports
+
+struct esp_lcd_panel_t
+{
+    host_panel_config_t config;
+    uint16_t *fbs[HOST_PANEL_MAX_FBS];         // Frame buffers owned by the panel
+    uint16_t *volatile cur_fb;                 // Frame buffer scanned out
+    uint16_t *volatile next_fb;                // Frame buffer to scan out from the next frame on, NULL if none
+    uint16_t *bounce_buf;                      // Bounce buffer handed to `on_bounce_empty`
+    uint16_t *screen;                          // Image on the glass
+    esp_lcd_rgb_panel_event_callbacks_t cbs;   // Event callbacks
+    void *user_ctx;                            // Argument of the event callbacks
+    pthread_mutex_t lock;                      // Protects the counters, the callbacks and `screen`
+    host_panel_stats_t stats;                  // Counters
+    pthread_t thread;                          // Thread emulating the LCD DMA
+};
+
+// Scan out one frame into `panel->screen`
+static void panel_scan_out(esp_lcd_panel_handle_t panel)
+{
+    const size_t frame_px = (size_t)panel->config.h_res * panel->config.v_res;
+
+    if (panel->next_fb != NULL)
+    {
+        panel->cur_fb = panel->next_fb; // A frame buffer switch takes effect at the start of a frame
+        panel->next_fb = NULL;
+    }
+
+    if (panel->config.bounce_buffer_size_px > 0 && panel->cbs.on_bounce_empty)
+    {
+        const size_t len_px = panel->config.bounce_buffer_size_px;
+        for (size_t pos = 0; pos < frame_px; pos += len_px)
+        {
+            panel->cbs.on_bounce_empty(panel, panel->bounce_buf, pos, len_px * sizeof(uint16_t), panel->user_ctx);
+            memcpy(panel->screen + pos, panel->bounce_buf, len_px * sizeof(uint16_t));
+        }
+        panel->stats.bounce_bytes += frame_px * sizeof(uint16_t);
+    }
+    else if (panel->cur_fb != NULL)
+    {
+        memcpy(panel->screen, panel->cur_fb, frame_px * sizeof(uint16_t));
+    }
+    panel->stats.frames++;
+}
+
+static void *panel_thread(void *arg)
+{
+    esp_lcd_panel_handle_t panel = arg;
+    const uint64_t period_ns = 1000000000ULL / panel->config.refresh_hz;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1)
+    {
+        pthread_mutex_lock(&panel->lock);
+        panel_scan_out(panel);
+        const esp_lcd_rgb_panel_vsync_cb_t on_vsync =
+            panel->config.bounce_buffer_size_px > 0 ? panel->cbs.on_bounce_frame_finish : panel->cbs.on_vsync;
+        pthread_mutex_unlock(&panel->lock);
+
+        if (on_vsync)
+        {
+            on_vsync(panel, NULL, panel->user_ctx); // The "ISR" runs on the DMA thread
+        }
+
+        next.tv_nsec += period_ns;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+        {
+        }
+    }
+    return NULL;
+}
+
+esp_err_t host_panel_new(const host_panel_config_t *config, esp_lcd_panel_handle_t *ret_panel)
+{
+    if (config == NULL || ret_panel == NULL || config->num_fbs > HOST_PANEL_MAX_FBS || config->refresh_hz == 0 ||
+        (config->num_fbs == 0 && config->bounce_buffer_size_px == 0) ||
+        (config->bounce_buffer_size_px > 0 && ((size_t)config->h_res * config->v_res) % config->bounce_buffer_size_px))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_panel_handle_t panel = calloc(1, sizeof(struct esp_lcd_panel_t));
+    if (panel == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    panel->config = *config;
+    const size_t frame_bytes = (size_t)config->h_res * config->v_res * sizeof(uint16_t);
+    for (uint32_t i = 0; i < config->num_fbs; i++)
+    {
+        panel->fbs[i] = heap_caps_aligned_calloc(64, 1, frame_bytes, MALLOC_CAP_SPIRAM);
+        if (panel->fbs[i] == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    panel->cur_fb = panel->fbs[0];
+    if (config->bounce_buffer_size_px > 0)
+    {
+        panel->bounce_buf = heap_caps_aligned_calloc(64, 1, config->bounce_buffer_size_px * sizeof(uint16_t), MALLOC_CAP_DMA);
+    }
+    panel->screen = calloc(1, frame_bytes);
+    if ((config->bounce_buffer_size_px > 0 && panel->bounce_buf == NULL) || panel->screen == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_mutex_init(&panel->lock, NULL);
+
+    if (pthread_create(&panel->thread, NULL, panel_thread, panel) != 0)
+    {
+        return ESP_FAIL;
+    }
+    pthread_detach(panel->thread);
+    *ret_panel = panel;
+    return ESP_OK;
+}
+
+void host_panel_get_stats(esp_lcd_panel_handle_t panel, host_panel_stats_t *stats)
+{
+    pthread_mutex_lock(&panel->lock);
+    *stats = panel->stats;
+    pthread_mutex_unlock(&panel->lock);
+}
+
+void host_panel_get_screen(esp_lcd_panel_handle_t panel, uint16_t *pixels)
+{
+    pthread_mutex_lock(&panel->lock);
+    memcpy(pixels, panel->screen, (size_t)panel->config.h_res * panel->config.v_res * sizeof(uint16_t));
+    pthread_mutex_unlock(&panel->lock);
+}
+
+esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_callbacks_t *callbacks, void *user_ctx)
+{
+    if (panel == NULL || callbacks == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&panel->lock);
+    panel->cbs = *callbacks;
+    panel->user_ctx = user_ctx;
+    pthread_mutex_unlock(&panel->lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t panel, uint32_t fb_num, void **fb0, ...)
+{
+    if (panel == NULL || fb_num == 0 || fb_num > panel->config.num_fbs)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    va_list args;
+    va_start(args, fb0);
+    *fb0 = panel->fbs[0];
+    for (uint32_t i = 1; i < fb_num; i++)
+    {
+        void **fb = va_arg(args, void **);
+        *fb = panel->fbs[i];
+    }
+    va_end(args);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    if (panel == NULL || panel->config.num_fbs == 0 || x_start >= x_end || y_start >= y_end)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Drawing one of the frame buffers switches the scan-out to it, anything else is copied into the current one
+    for (uint32_t i = 0; i < panel->config.num_fbs; i++)
+    {
+        if (color_data == panel->fbs[i])
+        {
+            panel->next_fb = panel->fbs[i];
+            return ESP_OK;
+        }
+    }
+
+    const int w = x_end - x_start;
+    const uint16_t *from = color_data;
+    for (int y = y_start; y < y_end; y++)
+    {
+        memcpy(panel->cur_fb + y * panel->config.h_res + x_start, from, w * sizeof(uint16_t));
+        from += w;
+    }
+    pthread_mutex_lock(&panel->lock);
+    panel->stats.bitmap_bytes += (uint64_t)w * (y_end - y_start) * sizeof(uint16_t);
+    pthread_mutex_unlock(&panel->lock);
+    return ESP_OK;
+}
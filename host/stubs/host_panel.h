@@ -0,0 +1,67 @@
+/*
+ * In-memory RGB565 panel standing in for the ESP32-S3 RGB LCD peripheral in the host build.
+ *
+ * A thread plays the part of the LCD DMA: once per frame period it scans the current frame buffer, or the
+ * bounce buffers filled by `on_bounce_empty`, into an image of the glass and then runs the vsync callback.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    uint16_t h_res;                 // Horizontal resolution
+    uint16_t v_res;                 // Vertical resolution
+    uint32_t num_fbs;               // Frame buffers owned by the panel, 0 if the bounce buffers are filled by callback
+    uint32_t bounce_buffer_size_px; // Size of a bounce buffer in pixels, 0 to scan out the frame buffer directly
+    uint32_t refresh_hz;            // Frames scanned out per second
+} host_panel_config_t;
+
+typedef struct
+{
+    uint32_t frames;       // Frames scanned out
+    uint64_t bitmap_bytes; // Bytes `esp_lcd_panel_draw_bitmap` copied into a frame buffer
+    uint64_t bounce_bytes; // Bytes the bounce buffer callback filled
+} host_panel_stats_t;
+
+/**
+ * @brief Create the panel and start scanning out
+ *
+ * @param[in] config: Panel configuration
+ * @param[out] ret_panel: Panel handle
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_NO_MEM: No memory for the frame buffers
+ */
+esp_err_t host_panel_new(const host_panel_config_t *config, esp_lcd_panel_handle_t *ret_panel);
+
+/**
+ * @brief Get the counters of the panel
+ *
+ * @param[in] panel: Panel handle
+ * @param[out] stats: Counters
+ */
+void host_panel_get_stats(esp_lcd_panel_handle_t panel, host_panel_stats_t *stats);
+
+/**
+ * @brief Copy the image on the glass, as of the last frame scanned out
+ *
+ * @param[in] panel: Panel handle
+ * @param[out] pixels: `h_res * v_res` RGB565 pixels
+ */
+void host_panel_get_screen(esp_lcd_panel_handle_t panel, uint16_t *pixels);
+
+#ifdef __cplusplus
+}
+#endif
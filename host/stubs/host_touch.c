@@ -0,0 +1,118 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "host_touch.h"
+
+struct esp_lcd_touch_s
+{
+    esp_lcd_touch_config_t config;
+    pthread_mutex_t lock; // Protects the fields below, the "I2C bus" and the test both use them
+    bool pressed;         // State of the panel
+    uint16_t x, y;        // Touched point on the panel
+    bool data_pressed;    // State read by the last `esp_lcd_touch_read_data()`
+    uint16_t data_x;      // Point read by the last `esp_lcd_touch_read_data()`, mirrored and swapped
+    uint16_t data_y;
+    uint32_t reads;       // Calls to `esp_lcd_touch_read_data()`
+};
+
+esp_err_t host_touch_new(const esp_lcd_touch_config_t *config, esp_lcd_touch_handle_t *ret_touch)
+{
+    if (config == NULL || ret_touch == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_lcd_touch_handle_t tp = calloc(1, sizeof(esp_lcd_touch_t));
+    if (tp == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    tp->config = *config;
+    pthread_mutex_init(&tp->lock, NULL);
+    *ret_touch = tp;
+    return ESP_OK;
+}
+
+// Report a change of the panel state the way the GT911 does, with a pulse on INT
+static void touch_interrupt(esp_lcd_touch_handle_t tp)
+{
+    if (tp->config.interrupt_callback)
+    {
+        tp->config.interrupt_callback(tp); // The "ISR" runs on the caller's thread
+    }
+}
+
+void host_touch_press(esp_lcd_touch_handle_t tp, uint16_t x, uint16_t y)
+{
+    pthread_mutex_lock(&tp->lock);
+    tp->pressed = true;
+    tp->x = x;
+    tp->y = y;
+    pthread_mutex_unlock(&tp->lock);
+    touch_interrupt(tp);
+}
+
+void host_touch_release(esp_lcd_touch_handle_t tp)
+{
+    pthread_mutex_lock(&tp->lock);
+    tp->pressed = false;
+    pthread_mutex_unlock(&tp->lock);
+    touch_interrupt(tp);
+}
+
+uint32_t host_touch_get_reads(esp_lcd_touch_handle_t tp)
+{
+    pthread_mutex_lock(&tp->lock);
+    const uint32_t reads = tp->reads;
+    pthread_mutex_unlock(&tp->lock);
+    return reads;
+}
+
+esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp)
+{
+    pthread_mutex_lock(&tp->lock);
+    tp->reads++;
+    tp->data_pressed = tp->pressed;
+
+    // Transform the point as esp_lcd_touch does after reading the controller
+    uint16_t x = tp->config.flags.mirror_x ? tp->config.x_max - tp->x : tp->x;
+    uint16_t y = tp->config.flags.mirror_y ? tp->config.y_max - tp->y : tp->y;
+    tp->data_x = tp->config.flags.swap_xy ? y : x;
+    tp->data_y = tp->config.flags.swap_xy ? x : y;
+    pthread_mutex_unlock(&tp->lock);
+    return ESP_OK;
+}
+
+bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num)
+{
+    pthread_mutex_lock(&tp->lock);
+    *point_num = (tp->data_pressed && max_point_num > 0) ? 1 : 0;
+    if (*point_num)
+    {
+        *x = tp->data_x;
+        *y = tp->data_y;
+        if (strength)
+        {
+            *strength = 1;
+        }
+    }
+    pthread_mutex_unlock(&tp->lock);
+    return *point_num > 0;
+}
+
+esp_err_t esp_lcd_touch_set_swap_xy(esp_lcd_touch_handle_t tp, bool swap)
+{
+    tp->config.flags.swap_xy = swap;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_touch_set_mirror_x(esp_lcd_touch_handle_t tp, bool mirror)
+{
+    tp->config.flags.mirror_x = mirror;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_touch_set_mirror_y(esp_lcd_touch_handle_t tp, bool mirror)
+{
+    tp->config.flags.mirror_y = mirror;
+    return ESP_OK;
+}
@@ -0,0 +1,44 @@
+/*
+ * Mock of the GT911 touch controller for the host build.
+ */
+
+#pragma once
+
+#include "esp_lcd_touch.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Create a touch controller, released until `host_touch_press()` is called
+ *
+ * @param[in] config: Touch configuration
+ * @param[out] ret_touch: Touch handle
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_NO_MEM: No memory
+ */
+esp_err_t host_touch_new(const esp_lcd_touch_config_t *config, esp_lcd_touch_handle_t *ret_touch);
+
+/**
+ * @brief Touch the panel at (x, y), or move the touch there, and raise INT like the GT911 does for a new report
+ */
+void host_touch_press(esp_lcd_touch_handle_t tp, uint16_t x, uint16_t y);
+
+/**
+ * @brief Lift the touch and raise INT for the release report
+ */
+void host_touch_release(esp_lcd_touch_handle_t tp);
+
+/**
+ * @brief Get the number of `esp_lcd_touch_read_data()` calls so far, each an I2C transaction on the board
+ */
+uint32_t host_touch_get_reads(esp_lcd_touch_handle_t tp);
+
+#ifdef __cplusplus
+}
+#endif
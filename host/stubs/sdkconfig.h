@@ -0,0 +1,42 @@
+/*
+ * Configuration of the host build: sdkconfig.defaults and the Kconfig defaults of the firmware.
+ *
+ * Targets that compare a feature against its fallback switch it off with `HOST_DISABLE_<option>`, options that
+ * are off by default are switched on with `HOST_ENABLE_<option>`, see `host_add_ui()` in CMakeLists.txt.
+ */
+
+#pragma once
+
+#define CONFIG_FREERTOS_HZ 1000
+
+#define CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT 10
+#define CONFIG_EXAMPLE_LVGL_PORT_MAX_FPS 30
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_PRIORITY 2
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_STACK_SIZE_KB 6
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_CORE 0
+#define CONFIG_EXAMPLE_LVGL_PORT_TICK 2
+#define CONFIG_EXAMPLE_LVGL_PORT_TOUCH_INTERRUPT 1
+
+#define CONFIG_EXAMPLE_LVGL_PORT_AVOID_TEAR_ENABLE 1
+#define CONFIG_EXAMPLE_LVGL_PORT_AVOID_TEAR_MODE_3 1
+#define CONFIG_EXAMPLE_LVGL_PORT_AVOID_TEAR_MODE 3
+#define CONFIG_EXAMPLE_LVGL_PORT_ROTATION_180 1
+#define CONFIG_EXAMPLE_LVGL_PORT_ROTATION_DEGREE 180
+#ifndef HOST_DISABLE_EXAMPLE_LVGL_PORT_ROTATION_SCANOUT
+#define CONFIG_EXAMPLE_LVGL_PORT_ROTATION_SCANOUT 1
+#endif
+#define CONFIG_EXAMPLE_LVGL_PORT_FLUSH_ASYNC 1
+#define CONFIG_EXAMPLE_LVGL_PORT_ROTATE_BLOCKED 1
+
+#ifndef HOST_DISABLE_UI_GAUGE_PRERENDERED
+#define CONFIG_UI_GAUGE_PRERENDERED 1
+#endif
+#ifndef HOST_DISABLE_UI_STATIC_LAYER
+#define CONFIG_UI_STATIC_LAYER 1
+#endif
+#ifndef HOST_DISABLE_UI_DIGIT_ATLAS
+#define CONFIG_UI_DIGIT_ATLAS 1
+#endif
+#ifdef HOST_ENABLE_UI_TICK_CHECK
+#define CONFIG_UI_TICK_CHECK 1
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Test of the interrupt-driven touch input of the LVGL port against the mock GT911: the controller must not
+ * be read while the panel is idle, and a press and a release must reach LVGL at the touched point.
+ *
+ * Usage: touch_test
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_lcd_panel_rgb.h"
+#include "esp_timer.h"
+#include "host_panel.h"
+#include "host_touch.h"
+#include "lvgl_port.h"
+#include "sdkconfig.h"
+
+#define TOUCH_TEST_IDLE_MS (300)    // Time the panel is left idle before and after the touch
+#define TOUCH_TEST_EVENT_MS (500)   // Longest wait for an input event
+#define TOUCH_TEST_X (100)          // Touched point, on the panel
+#define TOUCH_TEST_Y (200)
+
+static pthread_mutex_t test_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t test_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t test_pressed = 0;  // LV_EVENT_PRESSED received
+static uint32_t test_released = 0; // LV_EVENT_RELEASED received
+static lv_point_t test_point;      // Point of the last event
+static int64_t test_event_us;      // Time of the last event
+
+static void event_cb(lv_event_t *e)
+{
+    const lv_event_code_t code = lv_event_get_code(e);
+    if (code != LV_EVENT_PRESSED && code != LV_EVENT_RELEASED)
+    {
+        return;
+    }
+    pthread_mutex_lock(&test_lock);
+    lv_indev_get_point(lv_indev_get_act(), &test_point);
+    test_event_us = esp_timer_get_time();
+    if (code == LV_EVENT_PRESSED)
+    {
+        test_pressed++;
+    }
+    else
+    {
+        test_released++;
+    }
+    pthread_cond_broadcast(&test_cond);
+    pthread_mutex_unlock(&test_lock);
+}
+
+static bool rgb_lcd_on_vsync_event(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+{
+    return lvgl_port_notify_rgb_vsync();
+}
+
+#if LVGL_PORT_ROTATION_SCANOUT
+static bool rgb_lcd_on_bounce_empty(esp_lcd_panel_handle_t panel, void *bounce_buf, int pos_px, int len_bytes, void *user_ctx)
+{
+    return lvgl_port_fill_rgb_bounce_buffer(bounce_buf, pos_px, len_bytes);
+}
+#endif
+
+// Wait until `*counter` reaches `target` or `timeout_ms` passes, returns whether it was reached
+static bool test_wait(const uint32_t *counter, uint32_t target, uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&test_lock);
+    while (*counter < target && pthread_cond_timedwait(&test_cond, &test_lock, &deadline) == 0)
+    {
+    }
+    const bool reached = (*counter >= target);
+    pthread_mutex_unlock(&test_lock);
+    return reached;
+}
+
+// Check that the last event happened at the touched point, as LVGL sees it after the port's rotation
+static bool test_check_point(const char *event)
+{
+#if EXAMPLE_LVGL_PORT_ROTATION_180
+    const lv_point_t expected = {LVGL_PORT_H_RES - TOUCH_TEST_X, LVGL_PORT_V_RES - TOUCH_TEST_Y};
+#elif EXAMPLE_LVGL_PORT_ROTATION_90
+    const lv_point_t expected = {TOUCH_TEST_Y, LVGL_PORT_H_RES - TOUCH_TEST_X};
+#elif EXAMPLE_LVGL_PORT_ROTATION_270
+    const lv_point_t expected = {LVGL_PORT_V_RES - TOUCH_TEST_Y, TOUCH_TEST_X};
+#else
+    const lv_point_t expected = {TOUCH_TEST_X, TOUCH_TEST_Y};
+#endif
+    pthread_mutex_lock(&test_lock);
+    const lv_point_t point = test_point;
+    pthread_mutex_unlock(&test_lock);
+    if (point.x != expected.x || point.y != expected.y)
+    {
+        fprintf(stderr, "touch_test: %s at (%d, %d), expected (%d, %d)\n", event, point.x, point.y, expected.x, expected.y);
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    const host_panel_config_t panel_config = {
+        .h_res = LVGL_PORT_H_RES,
+        .v_res = LVGL_PORT_V_RES,
+#if LVGL_PORT_ROTATION_SCANOUT
+        .num_fbs = 0,
+#else
+        .num_fbs = LVGL_PORT_LCD_RGB_BUFFER_NUMS,
+#endif
+        .bounce_buffer_size_px = LVGL_PORT_H_RES * CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT,
+        .refresh_hz = 39,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    ESP_ERROR_CHECK(host_panel_new(&panel_config, &panel));
+
+    const esp_lcd_touch_config_t tp_config = {
+        .x_max = LVGL_PORT_H_RES,
+        .y_max = LVGL_PORT_V_RES,
+#if LVGL_PORT_TOUCH_INTERRUPT
+        .interrupt_callback = lvgl_port_notify_touch_interrupt,
+#endif
+    };
+    esp_lcd_touch_handle_t tp = NULL;
+    ESP_ERROR_CHECK(host_touch_new(&tp_config, &tp));
+
+    ESP_ERROR_CHECK(lvgl_port_init(panel, tp));
+
+    const esp_lcd_rgb_panel_event_callbacks_t cbs = {
+        .on_bounce_frame_finish = rgb_lcd_on_vsync_event,
+#if LVGL_PORT_ROTATION_SCANOUT
+        .on_bounce_empty = rgb_lcd_on_bounce_empty,
+#endif
+    };
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel, &cbs, NULL));
+
+    if (!lvgl_port_lock(-1))
+    {
+        return EXIT_FAILURE;
+    }
+    lv_obj_t *target = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(target, LV_PCT(100), LV_PCT(100));
+    lv_obj_add_event_cb(target, event_cb, LV_EVENT_ALL, NULL);
+    lvgl_port_unlock();
+
+    /* Idle: the controller isn't read at all */
+    usleep(TOUCH_TEST_IDLE_MS * 1000);
+    const uint32_t idle_reads = host_touch_get_reads(tp);
+    printf("reads while idle      %u\n", idle_reads);
+#if LVGL_PORT_TOUCH_INTERRUPT
+    if (idle_reads != 0)
+    {
+        fprintf(stderr, "touch_test: the controller was read %u times while idle\n", idle_reads);
+        return EXIT_FAILURE;
+    }
+#endif
+
+    /* Press and release: both reach LVGL at the touched point */
+    int64_t start = esp_timer_get_time();
+    host_touch_press(tp, TOUCH_TEST_X, TOUCH_TEST_Y);
+    if (!test_wait(&test_pressed, 1, TOUCH_TEST_EVENT_MS))
+    {
+        fprintf(stderr, "touch_test: the press didn't reach LVGL\n");
+        return EXIT_FAILURE;
+    }
+    printf("press latency         %.1f ms\n", (test_event_us - start) / 1000.0);
+    if (!test_check_point("press"))
+    {
+        return EXIT_FAILURE;
+    }
+
+    start = esp_timer_get_time();
+    host_touch_release(tp);
+    if (!test_wait(&test_released, 1, TOUCH_TEST_EVENT_MS))
+    {
+        fprintf(stderr, "touch_test: the release didn't reach LVGL\n");
+        return EXIT_FAILURE;
+    }
+    printf("release latency       %.1f ms\n", (test_event_us - start) / 1000.0);
+    if (!test_check_point("release"))
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Idle again: the reads stop with the release */
+    const uint32_t touch_reads = host_touch_get_reads(tp);
+    usleep(TOUCH_TEST_IDLE_MS * 1000);
+    const uint32_t after_reads = host_touch_get_reads(tp) - touch_reads;
+    printf("reads while touched   %u\n", touch_reads - idle_reads);
+    printf("reads after release   %u\n", after_reads);
+#if LVGL_PORT_TOUCH_INTERRUPT
+    if (after_reads != 0)
+    {
+        fprintf(stderr, "touch_test: the controller was read %u times after the release\n", after_reads);
+        return EXIT_FAILURE;
+    }
+#endif
+    return EXIT_SUCCESS;
+}
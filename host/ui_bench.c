@@ -0,0 +1,292 @@
+/*
+ * Headless benchmark of the UI stack: the LVGL port renders the main screen into the in-memory panel while a
+ * script publishes changing native variables, one UI tick per step, and the frame costs are reported.
+ *
+ * Usage: ui_bench [steps]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "esp_lcd_panel_rgb.h"
+#include "gauge.h"
+#include "host_panel.h"
+#include "host_touch.h"
+#include "lvgl_port.h"
+#include "sdkconfig.h"
+#include "static_layer.h"
+#include "ui.h"
+#include "vars.h"
+
+#define UI_BENCH_DEFAULT_STEPS (200)
+#define UI_BENCH_FRAME_TIMEOUT_MS (200) // Longest wait for the frame of a step, a step may change nothing visible
+
+// Scan-out rate of the Waveshare panel: 16 MHz pixel clock over 800x480 plus the porches and sync pulses
+#define UI_BENCH_REFRESH_HZ (16 * 1000 * 1000 / ((LVGL_PORT_H_RES + 4 + 8 + 8) * (LVGL_PORT_V_RES + 4 + 8 + 8)))
+
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bench_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t bench_ticks = 0;   // UI ticks run by the LVGL task
+static uint32_t bench_frames = 0;  // Refreshes LVGL completed
+static uint64_t bench_pixels = 0;  // Pixels LVGL rendered
+
+static void ui_tick_cb(void *user_data)
+{
+    ui_tick();
+    pthread_mutex_lock(&bench_lock);
+    bench_ticks++;
+    pthread_cond_broadcast(&bench_cond);
+    pthread_mutex_unlock(&bench_lock);
+}
+
+static void monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    pthread_mutex_lock(&bench_lock);
+    bench_frames++;
+    bench_pixels += px;
+    pthread_cond_broadcast(&bench_cond);
+    pthread_mutex_unlock(&bench_lock);
+}
+
+static bool rgb_lcd_on_vsync_event(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+{
+    return lvgl_port_notify_rgb_vsync();
+}
+
+#if LVGL_PORT_ROTATION_SCANOUT
+static bool rgb_lcd_on_bounce_empty(esp_lcd_panel_handle_t panel, void *bounce_buf, int pos_px, int len_bytes, void *user_ctx)
+{
+    return lvgl_port_fill_rgb_bounce_buffer(bounce_buf, pos_px, len_bytes);
+}
+#endif
+
+// Deterministic pseudo-random number in [0, n)
+static uint32_t script_rand(uint32_t n)
+{
+    static uint32_t state = 12345;
+    state = state * 1664525 + 1013904223;
+    return (state >> 8) % n;
+}
+
+// Walk `value` by up to `step` in either direction, within [min, max]
+static int32_t script_walk(int32_t value, int32_t step, int32_t min, int32_t max)
+{
+    value += (int32_t)script_rand(2 * step + 1) - step;
+    return value < min ? min : (value > max ? max : value);
+}
+
+// Publish what the devices would report at `step`: the power readings change every step, the slower values less often
+static void script_step(uint32_t step)
+{
+    static const native_code_t inv_modes[] = {VICTRON_MODE_INVERTING, VICTRON_MODE_LOW_POWER, VICTRON_MODE_ASSISTING};
+    static const native_code_t solar_modes[] = {VICTRON_MODE_BULK, VICTRON_MODE_ABSORPTION, VICTRON_MODE_FLOAT, VICTRON_MODE_OFF};
+    static int32_t ac_watts = 350;
+    static int32_t solar_watts = 120;
+    static int32_t batt_centiamps = -1500;
+    static int32_t batt_centivolts = 1320;
+    static int32_t batt_soc = 80;
+
+    ac_watts = script_walk(ac_watts, 40, 0, 3000);
+    solar_watts = script_walk(solar_watts, 15, 0, 400);
+    batt_centiamps = script_walk(batt_centiamps, 150, -5000, 3000);
+    batt_centivolts = script_walk(batt_centivolts, 2, 1150, 1460);
+    native_var_publish_int(NATIVE_VAR_AC_WATTS, ac_watts);
+    native_var_publish_int(NATIVE_VAR_SOLAR_WATTS, solar_watts);
+    native_var_publish_float(NATIVE_VAR_BATT_AMP, batt_centiamps / 100.0f);
+    native_var_publish_float(NATIVE_VAR_BATT_VOLT, batt_centivolts / 100.0f);
+
+    if (step % 10 == 0)
+    {
+        batt_soc = script_walk(batt_soc, 1, 0, 100);
+        native_var_publish_float(NATIVE_VAR_BATT_SOC, batt_soc);
+        native_var_publish_int(NATIVE_VAR_SOLAR_YIELD, step);
+    }
+    if (step % 20 == 0)
+    {
+        native_var_publish_int(NATIVE_VAR_BATT_TEMP, script_walk(20, 3, 0, 40));
+    }
+    if (step % 50 == 0)
+    {
+        native_var_publish_code(NATIVE_VAR_INV_MODE, inv_modes[script_rand(3)]);
+        native_var_publish_code(NATIVE_VAR_SOLAR_MODE, solar_modes[script_rand(4)]);
+    }
+}
+
+// Publish the values the firmware publishes before `ui_init()`
+static void script_init(void)
+{
+    native_var_publish_bool(NATIVE_VAR_INV_SWITCH, true);
+    native_var_publish_int(NATIVE_VAR_BATT_TEMP, 20);
+    native_var_publish_int(NATIVE_VAR_BACKLIGHT_DELAY, 30);
+    native_var_publish_string(NATIVE_VAR_IP_ADDR, "192.168.1.20");
+    native_var_publish_code(NATIVE_VAR_INV_MODE, 9);    // Inverting
+    native_var_publish_code(NATIVE_VAR_SOLAR_MODE, 3);  // Bulk
+    native_var_publish_code(NATIVE_VAR_INV_ERROR, VICTRON_VEBUS_ERROR_NONE);
+    native_var_publish_code(NATIVE_VAR_SOLAR_ERROR, VICTRON_CHARGER_ERROR_NONE);
+    native_var_publish_code(NATIVE_VAR_BATT_ALARM, 0); // No alarm
+}
+
+// Wait until `*counter` reaches `target` or `timeout_ms` passes, returns whether it was reached
+static bool bench_wait(const uint32_t *counter, uint32_t target, uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    while (*counter < target && pthread_cond_timedwait(&bench_cond, &bench_lock, &deadline) == 0)
+    {
+    }
+    const bool reached = (*counter >= target);
+    pthread_mutex_unlock(&bench_lock);
+    return reached;
+}
+
+static void print_stat(const char *name, const lvgl_port_stat_t *stat, double scale)
+{
+    printf("%-20s avg %8.3f  p99 %8.3f  max %8.3f\n", name, stat->avg * scale, stat->p99 * scale, stat->max * scale);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t steps = (argc > 1) ? strtoul(argv[1], NULL, 0) : UI_BENCH_DEFAULT_STEPS;
+
+    /* Bring the panel, the port and the UI up the way `waveshare_esp32_s3_rgb_lcd_init()` and main.rs do */
+    const host_panel_config_t panel_config = {
+        .h_res = LVGL_PORT_H_RES,
+        .v_res = LVGL_PORT_V_RES,
+#if LVGL_PORT_ROTATION_SCANOUT
+        .num_fbs = 0,
+#else
+        .num_fbs = LVGL_PORT_LCD_RGB_BUFFER_NUMS,
+#endif
+        .bounce_buffer_size_px = LVGL_PORT_H_RES * CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT,
+        .refresh_hz = UI_BENCH_REFRESH_HZ,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    ESP_ERROR_CHECK(host_panel_new(&panel_config, &panel));
+
+    const esp_lcd_touch_config_t tp_config = {
+        .x_max = LVGL_PORT_H_RES,
+        .y_max = LVGL_PORT_V_RES,
+#if LVGL_PORT_TOUCH_INTERRUPT
+        .interrupt_callback = lvgl_port_notify_touch_interrupt,
+#endif
+    };
+    esp_lcd_touch_handle_t tp = NULL;
+    ESP_ERROR_CHECK(host_touch_new(&tp_config, &tp));
+
+    ESP_ERROR_CHECK(lvgl_port_init(panel, tp));
+
+    const esp_lcd_rgb_panel_event_callbacks_t cbs = {
+        .on_bounce_frame_finish = rgb_lcd_on_vsync_event,
+#if LVGL_PORT_ROTATION_SCANOUT
+        .on_bounce_empty = rgb_lcd_on_bounce_empty,
+#endif
+    };
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel, &cbs, NULL));
+
+    if (!lvgl_port_lock(-1))
+    {
+        return EXIT_FAILURE;
+    }
+    script_init();
+    ui_init();
+    lv_disp_get_default()->driver->monitor_cb = monitor_cb;
+    lvgl_port_unlock();
+
+    /* Let the first, full frame go before measuring */
+    bench_wait(&bench_frames, 1, 1000);
+    pthread_mutex_lock(&bench_lock);
+    const uint32_t frames_start = bench_frames;
+    const uint64_t pixels_start = bench_pixels;
+    pthread_mutex_unlock(&bench_lock);
+    host_panel_stats_t panel_start;
+    host_panel_get_stats(panel, &panel_start);
+    gauge_stats_t gauge_start;
+    eez_alloc_stats_t alloc_start;
+    lvgl_port_lock(-1);
+    gauge_get_stats(&gauge_start);
+    eez_flow_get_alloc_stats(&alloc_start);
+    lvgl_port_unlock();
+
+    for (uint32_t step = 0; step < steps; step++)
+    {
+        pthread_mutex_lock(&bench_lock);
+        const uint32_t frames_before = bench_frames;
+        pthread_mutex_unlock(&bench_lock);
+        script_step(step);
+        if (!lvgl_port_post_call(ui_tick_cb, NULL) || !bench_wait(&bench_ticks, step + 1, 1000))
+        {
+            fprintf(stderr, "ui_bench: tick %u did not run\n", step);
+            return EXIT_FAILURE;
+        }
+        bench_wait(&bench_frames, frames_before + 1, UI_BENCH_FRAME_TIMEOUT_MS);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    const uint32_t frames = bench_frames - frames_start;
+    const uint64_t pixels = bench_pixels - pixels_start;
+    pthread_mutex_unlock(&bench_lock);
+    host_panel_stats_t panel_stats;
+    host_panel_get_stats(panel, &panel_stats);
+    lvgl_port_stats_t stats;
+    lvgl_port_get_stats(&stats);
+    gauge_stats_t gauge;
+    lvgl_port_lock(-1);
+    gauge_get_stats(&gauge);
+    static_layer_stats_t layer;
+    static_layer_get_stats(&layer);
+    eez_alloc_stats_t alloc;
+    eez_flow_get_alloc_stats(&alloc);
+    lvgl_port_unlock();
+    const uint32_t gauge_draws = gauge.draws - gauge_start.draws;
+    const uint32_t gauge_changes = gauge.changes - gauge_start.changes;
+    const uint32_t gauge_us = gauge.draw_us - gauge_start.draw_us;
+
+    if (frames == 0)
+    {
+        fprintf(stderr, "ui_bench: nothing was rendered\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("steps                %u\n", steps);
+    printf("frames               %u\n", frames);
+    printf("pixels/frame         %.0f\n", (double)pixels / frames);
+    printf("-- last %u frames, ms --\n", stats.samples);
+    print_stat("render", &stats.render_us, 1e-3);
+    print_stat("timer handler", &stats.timer_handler_us, 1e-3);
+    print_stat("flush", &stats.flush_us, 1e-3);
+    print_stat("copy", &stats.copy_us, 1e-3);
+    printf("-- bytes copied --\n");
+    print_stat("port copy/frame", &stats.copy_bytes, 1);
+    printf("%-20s %.0f\n", "panel bitmap/frame", (double)(panel_stats.bitmap_bytes - panel_start.bitmap_bytes) / frames);
+    printf("%-20s %.0f\n", "scan-out/refresh",
+           (double)(panel_stats.bounce_bytes - panel_start.bounce_bytes) / (panel_stats.frames - panel_start.frames));
+    printf("-- gauges, %s, ms --\n", gauge.prerendered ? "pre-rendered" : "lv_arc");
+    printf("%-20s %u\n", "draws", gauge_draws);
+    printf("%-20s %u\n", "value changes", gauge_changes);
+    printf("%-20s %8.3f\n", "draw", gauge_draws ? gauge_us * 1e-3 / gauge_draws : 0.0);
+    printf("%-20s %8.3f\n", "value change", gauge_changes ? gauge_us * 1e-3 / gauge_changes : 0.0);
+    printf("%-20s %8.3f\n", "max draw", gauge.max_draw_us * 1e-3);
+    printf("%-20s %u\n", "mask bytes", gauge.shape_bytes);
+    printf("-- flow allocations --\n");
+    printf("%-20s %u\n", "allocs", alloc.allocs - alloc_start.allocs);
+    printf("%-20s %u\n", "flow ticks", alloc.ticks - alloc_start.ticks);
+    printf("%-20s %.2f\n", "allocs/tick",
+           alloc.ticks != alloc_start.ticks ? (double)(alloc.allocs - alloc_start.allocs) / (alloc.ticks - alloc_start.ticks) : 0.0);
+    printf("-- static layers --\n");
+    printf("%-20s %u\n", "layers", layer.layers);
+    printf("%-20s %u\n", "widgets", layer.widgets);
+    printf("%-20s %u\n", "rebuilds", layer.rebuilds);
+    printf("%-20s %u\n", "bytes", layer.bytes);
+    return EXIT_SUCCESS;
+}
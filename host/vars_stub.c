@@ -0,0 +1,54 @@
+/*
+ * Native variables of the UI for the host build, standing in for src/ui/vars.rs.
+ *
+ * Every getter reads the snapshot the tick evaluates against, so the benchmark drives the UI by publishing
+ * values with `native_var_publish_*()`, exactly as the firmware does. Writes from the UI only bump the
+ * version, like the firmware's read-only variables.
+ */
+
+#include "vars.h"
+
+#define NATIVE_VAR_VALUE(type, var) (*(const type *)native_var_value(var))
+
+#define NATIVE_VAR_STUB(name, type, getter_type, var)                     \
+    getter_type get_var_##name()                                          \
+    {                                                                     \
+        return NATIVE_VAR_VALUE(type, var);                               \
+    }                                                                     \
+    void set_var_##name(getter_type value)                                \
+    {                                                                     \
+        native_var_changed(var);                                          \
+    }
+
+#define NATIVE_VAR_STRING_STUB(name, var)                                 \
+    const char *get_var_##name()                                          \
+    {                                                                     \
+        return (const char *)native_var_value(var);                       \
+    }                                                                     \
+    void set_var_##name(const char *value)                                \
+    {                                                                     \
+        native_var_changed(var);                                          \
+    }
+
+NATIVE_VAR_STUB(inv_switch, bool, bool, NATIVE_VAR_INV_SWITCH)
+NATIVE_VAR_STRING_STUB(inv_mode, NATIVE_VAR_INV_MODE)
+NATIVE_VAR_STRING_STUB(inv_error, NATIVE_VAR_INV_ERROR)
+NATIVE_VAR_STUB(ac_watts, int32_t, int32_t, NATIVE_VAR_AC_WATTS)
+NATIVE_VAR_STUB(batt_soc, float, float, NATIVE_VAR_BATT_SOC)
+NATIVE_VAR_STUB(batt_volt, float, float, NATIVE_VAR_BATT_VOLT)
+NATIVE_VAR_STUB(batt_amp, float, float, NATIVE_VAR_BATT_AMP)
+NATIVE_VAR_STUB(batt_temp, int32_t, int32_t, NATIVE_VAR_BATT_TEMP)
+NATIVE_VAR_STRING_STUB(batt_alarm, NATIVE_VAR_BATT_ALARM)
+NATIVE_VAR_STUB(solar_watts, int32_t, int32_t, NATIVE_VAR_SOLAR_WATTS)
+NATIVE_VAR_STUB(solar_yield, int32_t, int32_t, NATIVE_VAR_SOLAR_YIELD)
+NATIVE_VAR_STRING_STUB(solar_mode, NATIVE_VAR_SOLAR_MODE)
+NATIVE_VAR_STRING_STUB(solar_error, NATIVE_VAR_SOLAR_ERROR)
+NATIVE_VAR_STRING_STUB(ip_addr, NATIVE_VAR_IP_ADDR)
+NATIVE_VAR_STUB(backlight_delay, int32_t, int32_t, NATIVE_VAR_BACKLIGHT_DELAY)
+NATIVE_VAR_STRING_STUB(inv_mac, NATIVE_VAR_INV_MAC)
+NATIVE_VAR_STRING_STUB(inv_key, NATIVE_VAR_INV_KEY)
+NATIVE_VAR_STRING_STUB(inv_pin, NATIVE_VAR_INV_PIN)
+NATIVE_VAR_STRING_STUB(mppt_mac, NATIVE_VAR_MPPT_MAC)
+NATIVE_VAR_STRING_STUB(mppt_key, NATIVE_VAR_MPPT_KEY)
+NATIVE_VAR_STRING_STUB(bmv_mac, NATIVE_VAR_BMV_MAC)
+NATIVE_VAR_STRING_STUB(bmv_key, NATIVE_VAR_BMV_KEY)
@@ -1,4 +1,3 @@
-use std::ffi::CString;
 use std::slice;
 use std::sync::mpsc::{Receiver, SyncSender, sync_channel};
 use std::sync::{Arc, Mutex, RwLock};
@@ -10,6 +9,11 @@ use esp_idf_svc::bt::ble::gatt::client::{
     GattWriteType, GattcEvent, ServiceElement, ServiceSource,
 };
 use esp_idf_svc::bt::ble::gatt::{GattInterface, GattStatus, Handle};
+use esp_idf_svc::sys::lcd_bindings::{
+    NativeVariables_NATIVE_VAR_BATT_ALARM, NativeVariables_NATIVE_VAR_INV_ERROR,
+    NativeVariables_NATIVE_VAR_INV_MODE, NativeVariables_NATIVE_VAR_INV_SWITCH,
+    NativeVariables_NATIVE_VAR_SOLAR_ERROR, NativeVariables_NATIVE_VAR_SOLAR_MODE,
+};
 use esp_idf_svc::sys::*;
 
 use anyhow::Result;
@@ -21,10 +25,10 @@ use esp_idf_svc::bt::ble::gap::{
 use esp_idf_svc::bt::{BdAddr, Ble, BtDriver, BtStatus, BtUuid};
 use esp_idf_svc::sys::EspError;
 use log::{debug, error, info, warn};
-use victron_ble::{DeviceState, ErrorState, Mode};
+use victron_ble::{DeviceState, Mode};
 
 use crate::devices::*;
-use crate::ui::{self, ON_DURATION};
+use crate::ui::{self, NativeValue, ON_DURATION};
 
 type VicBtDriver = BtDriver<'static, Ble>;
 type VicEspBleGap = Arc<EspBleGap<'static, Ble, Arc<VicBtDriver>>>;
@@ -264,22 +268,17 @@ impl Client {
                                             as i32;
 
                                     if device_state.mode != Mode::NotApplicable {
-                                        ui::SOLAR_MODE.write().unwrap().replace(
-                                            CString::new(format!("{}", device_state.mode)).unwrap(),
+                                        ui::publish_code(
+                                            NativeVariables_NATIVE_VAR_SOLAR_MODE,
+                                            ui::mode_code(device_state.mode),
                                         );
                                     }
 
-                                    let cur_error = ui::SOLAR_ERROR.read().unwrap().is_some();
-                                    if device_state.error_state != ErrorState::NoError
-                                        && device_state.error_state != ErrorState::NotApplicable
-                                    {
-                                        ui::SOLAR_ERROR.write().unwrap().replace(
-                                            CString::new(format!("{}", device_state.error_state))
-                                                .unwrap(),
-                                        );
-                                    } else if cur_error {
-                                        ui::SOLAR_ERROR.write().unwrap().take();
-                                    }
+                                    // No error and not applicable both show nothing
+                                    ui::publish_code(
+                                        NativeVariables_NATIVE_VAR_SOLAR_ERROR,
+                                        ui::charger_error_code(device_state.error_state),
+                                    );
                                 }
                                 Ok(DeviceState::VeBus(device_state)) => {
                                     debug!("Read VeBus: {device_state:?} ");
@@ -300,6 +299,8 @@ impl Client {
                                                     false,
                                                     std::sync::atomic::Ordering::Relaxed,
                                                 );
+                                                false
+                                                    .publish(NativeVariables_NATIVE_VAR_INV_SWITCH);
                                             }
                                             Mode::Inverting => {
                                                 ui::INVERTER_ON.store(
@@ -310,10 +311,12 @@ impl Client {
                                                     true,
                                                     std::sync::atomic::Ordering::Relaxed,
                                                 );
+                                                true.publish(NativeVariables_NATIVE_VAR_INV_SWITCH);
                                             }
                                             mode => {
-                                                ui::INV_MODE.write().unwrap().replace(
-                                                    CString::new(format!("{mode}")).unwrap(),
+                                                ui::publish_code(
+                                                    NativeVariables_NATIVE_VAR_INV_MODE,
+                                                    ui::mode_code(mode),
                                                 );
                                             }
                                         }
@@ -332,17 +335,10 @@ impl Client {
                                     *(lock.unwrap()) =
                                         device_state.ac_out_power_w.unwrap_or(0_f32) as i32;
 
-                                    let cur_error = ui::INV_ERROR.read().unwrap().is_some();
-                                    if device_state.error != ErrorState::NoError
-                                        && device_state.error != ErrorState::NotApplicable
-                                    {
-                                        ui::INV_ERROR.write().unwrap().replace(
-                                            CString::new(format!("{}", device_state.error))
-                                                .unwrap(),
-                                        );
-                                    } else if cur_error {
-                                        ui::INV_ERROR.write().unwrap().take();
-                                    }
+                                    ui::publish_code(
+                                        NativeVariables_NATIVE_VAR_INV_ERROR,
+                                        ui::vebus_error_code(device_state.error),
+                                    );
                                 }
                                 Ok(DeviceState::BatteryMonitor(device_state)) => {
                                     debug!("Read Batt: {device_state:?} ");
@@ -365,18 +361,11 @@ impl Client {
                                         true,
                                     );
 
-                                    let cur_alarm = ui::BATT_ALARM.read().unwrap().is_some();
-                                    if !device_state.alarm_reason.is_empty() {
-                                        ui::BATT_ALARM.write().unwrap().replace(
-                                            CString::new(format!(
-                                                "{:?}",
-                                                device_state.alarm_reason
-                                            ))
-                                            .unwrap(),
-                                        );
-                                    } else if cur_alarm {
-                                        ui::BATT_ALARM.write().unwrap().take();
-                                    }
+                                    ui::publish_code(
+                                        NativeVariables_NATIVE_VAR_BATT_ALARM,
+                                        // The VictronAlarm bits are the protocol's alarm reason bits
+                                        device_state.alarm_reason.bits(),
+                                    );
                                 }
                                 Ok(_device) => {
                                     // info!("{} Unknown device state {device:?}", result.bda);
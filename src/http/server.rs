@@ -1,3 +1,5 @@
+use std::mem;
+
 use embedded_svc::{
     http::{Headers, Method},
     io::{Read, Write},
@@ -9,13 +11,20 @@ use esp_idf_svc::{
         self,
         server::{EspHttpConnection, EspHttpServer, Request},
     },
+    sys::lcd_bindings::{
+        digit_atlas_get_stats, digit_atlas_stats_t, eez_alloc_class_stats_t, eez_alloc_stats_t,
+        eez_flow_get_alloc_stats, eez_flow_get_text_cache_stats, eez_text_cache_stats_t,
+        gauge_get_stats, gauge_stats_t, lvgl_port_get_queue_stats, lvgl_port_get_shadow_stats,
+        lvgl_port_get_stats, lvgl_port_queue_stats_t, lvgl_port_shadow_stats_t, lvgl_port_stat_t,
+        lvgl_port_stats_t, static_layer_get_stats, static_layer_stats_t,
+    },
 };
 
 use anyhow::Result;
 use hex::FromHex;
 use log::*;
 
-use serde::Deserialize;
+use serde::{Deserialize, Serialize};
 
 use crate::devices::{DEVICES, Device, DeviceType, Key, Mac};
 
@@ -38,6 +47,248 @@ struct ConfigData<'a> {
     inv_pin: u32,
 }
 
+#[derive(Serialize)]
+struct Stat {
+    min: u32,
+    avg: u32,
+    p99: u32,
+    max: u32,
+}
+
+impl From<lvgl_port_stat_t> for Stat {
+    fn from(stat: lvgl_port_stat_t) -> Self {
+        Self {
+            min: stat.min,
+            avg: stat.avg,
+            p99: stat.p99,
+            max: stat.max,
+        }
+    }
+}
+
+// Rendering statistics of the recent frames, see `lvgl_port_stats_t`
+#[derive(Serialize)]
+struct RenderStats {
+    frames: u32,
+    samples: u32,
+    full_copies: u32,
+    timer_handler_us: Stat,
+    render_us: Stat,
+    copy_us: Stat,
+    copy_bytes: Stat,
+    vsync_wait_us: Stat,
+    flush_us: Stat,
+    queue: QueueStats,
+    text_cache: TextCacheStats,
+    gauge: GaugeStats,
+    static_layer: StaticLayerStats,
+    shadow_cache: ShadowCacheStats,
+    digit_atlas: DigitAtlasStats,
+    flow_alloc: FlowAllocStats,
+}
+
+// Counters of the UI command queue, see `lvgl_port_queue_stats_t`
+#[derive(Serialize)]
+struct QueueStats {
+    depth: u32,
+    max_depth: u32,
+    posted: u32,
+    dropped: u32,
+}
+
+impl From<lvgl_port_queue_stats_t> for QueueStats {
+    fn from(stats: lvgl_port_queue_stats_t) -> Self {
+        Self {
+            depth: stats.depth,
+            max_depth: stats.max_depth,
+            posted: stats.posted,
+            dropped: stats.dropped,
+        }
+    }
+}
+
+// Formatted label text cache of the UI tick, see `eez_text_cache_stats_t`
+#[derive(Serialize)]
+struct TextCacheStats {
+    hits: u32,
+    misses: u32,
+}
+
+impl From<eez_text_cache_stats_t> for TextCacheStats {
+    fn from(stats: eez_text_cache_stats_t) -> Self {
+        Self {
+            hits: stats.hits,
+            misses: stats.misses,
+        }
+    }
+}
+
+// Draw time of the arc gauges, see `gauge_stats_t`
+#[derive(Serialize)]
+struct GaugeStats {
+    prerendered: bool,
+    draws: u32,
+    changes: u32,
+    avg_draw_us: u32,
+    avg_change_us: u32,
+    max_draw_us: u32,
+    shape_bytes: u32,
+}
+
+impl From<gauge_stats_t> for GaugeStats {
+    fn from(stats: gauge_stats_t) -> Self {
+        Self {
+            prerendered: stats.prerendered,
+            draws: stats.draws,
+            changes: stats.changes,
+            avg_draw_us: stats.draw_us.checked_div(stats.draws).unwrap_or(0),
+            avg_change_us: stats.draw_us.checked_div(stats.changes).unwrap_or(0),
+            max_draw_us: stats.max_draw_us,
+            shape_bytes: stats.shape_bytes,
+        }
+    }
+}
+
+// Cached static widgets of the main screen, see `static_layer_stats_t`
+#[derive(Serialize)]
+struct StaticLayerStats {
+    layers: u32,
+    widgets: u32,
+    rebuilds: u32,
+    bytes: u32,
+}
+
+impl From<static_layer_stats_t> for StaticLayerStats {
+    fn from(stats: static_layer_stats_t) -> Self {
+        Self {
+            layers: stats.layers,
+            widgets: stats.widgets,
+            rebuilds: stats.rebuilds,
+            bytes: stats.bytes,
+        }
+    }
+}
+
+// Shadow corner cache of the software renderer, see `lvgl_port_shadow_stats_t`. The hits and misses are estimates
+#[derive(Serialize)]
+struct ShadowCacheStats {
+    hits: u32,
+    misses: u32,
+    draws: u32,
+    avg_draw_us: u32,
+}
+
+impl From<lvgl_port_shadow_stats_t> for ShadowCacheStats {
+    fn from(stats: lvgl_port_shadow_stats_t) -> Self {
+        Self {
+            hits: stats.hits,
+            misses: stats.misses,
+            draws: stats.draws,
+            avg_draw_us: stats.draw_us.checked_div(stats.draws).unwrap_or(0),
+        }
+    }
+}
+
+// Numeric labels drawn from glyph atlases, see `digit_atlas_stats_t`
+#[derive(Serialize)]
+struct DigitAtlasStats {
+    enabled: bool,
+    draws: u32,
+    avg_draw_us: u32,
+    fallbacks: u32,
+    atlases: u32,
+    bytes: u32,
+}
+
+impl From<digit_atlas_stats_t> for DigitAtlasStats {
+    fn from(stats: digit_atlas_stats_t) -> Self {
+        Self {
+            enabled: stats.enabled,
+            draws: stats.draws,
+            avg_draw_us: stats.draw_us.checked_div(stats.draws).unwrap_or(0),
+            fallbacks: stats.fallbacks,
+            atlases: stats.atlases,
+            bytes: stats.bytes,
+        }
+    }
+}
+
+// Slab allocator of the EEZ flow values, see `eez_alloc_stats_t`
+#[derive(Serialize)]
+struct FlowAllocStats {
+    classes: Vec<FlowAllocClassStats>,
+    arena_size: u32,
+    arena_used: u32,
+    heap_blocks: u32,
+    heap_allocs: u32,
+    // Allocations per flow tick since start-up, short strings don't count as they're kept in the value
+    allocs_per_tick: f32,
+}
+
+#[derive(Serialize)]
+struct FlowAllocClassStats {
+    block_size: u32,
+    blocks: u32,
+    used: u32,
+    peak: u32,
+}
+
+impl From<eez_alloc_class_stats_t> for FlowAllocClassStats {
+    fn from(stats: eez_alloc_class_stats_t) -> Self {
+        Self {
+            block_size: stats.block_size,
+            blocks: stats.blocks,
+            used: stats.used,
+            peak: stats.peak,
+        }
+    }
+}
+
+impl From<eez_alloc_stats_t> for FlowAllocStats {
+    fn from(stats: eez_alloc_stats_t) -> Self {
+        Self {
+            classes: stats.classes.into_iter().map(Into::into).collect(),
+            arena_size: stats.arena_size,
+            arena_used: stats.arena_used,
+            heap_blocks: stats.heap_blocks,
+            heap_allocs: stats.heap_allocs,
+            allocs_per_tick: stats.allocs as f32 / stats.ticks.max(1) as f32,
+        }
+    }
+}
+
+impl RenderStats {
+    fn new(
+        stats: lvgl_port_stats_t,
+        queue: lvgl_port_queue_stats_t,
+        text_cache: eez_text_cache_stats_t,
+        gauge: gauge_stats_t,
+        static_layer: static_layer_stats_t,
+        shadow_cache: lvgl_port_shadow_stats_t,
+        digit_atlas: digit_atlas_stats_t,
+        flow_alloc: eez_alloc_stats_t,
+    ) -> Self {
+        Self {
+            frames: stats.frames,
+            samples: stats.samples,
+            full_copies: stats.full_copies,
+            timer_handler_us: stats.timer_handler_us.into(),
+            render_us: stats.render_us.into(),
+            copy_us: stats.copy_us.into(),
+            copy_bytes: stats.copy_bytes.into(),
+            vsync_wait_us: stats.vsync_wait_us.into(),
+            flush_us: stats.flush_us.into(),
+            queue: queue.into(),
+            text_cache: text_cache.into(),
+            gauge: gauge.into(),
+            static_layer: static_layer.into(),
+            shadow_cache: shadow_cache.into(),
+            digit_atlas: digit_atlas.into(),
+            flow_alloc: flow_alloc.into(),
+        }
+    }
+}
+
 pub struct HttpServer<'a> {
     _server: EspHttpServer<'a>,
 }
@@ -53,6 +304,7 @@ impl<'a> HttpServer<'a> {
 
         server.fn_handler::<anyhow::Error, _>("/", Method::Get, HttpServer::index)?;
         server.fn_handler::<anyhow::Error, _>("/post", Method::Post, HttpServer::config)?;
+        server.fn_handler::<anyhow::Error, _>("/stats", Method::Get, HttpServer::stats)?;
 
         Ok(Self { _server: server })
     }
@@ -166,6 +418,44 @@ impl<'a> HttpServer<'a> {
         Ok(())
     }
 
+    fn stats(req: Request<&mut EspHttpConnection<'_>>) -> Result<()> {
+        let mut stats: lvgl_port_stats_t = unsafe { mem::zeroed() };
+        let mut queue: lvgl_port_queue_stats_t = unsafe { mem::zeroed() };
+        let mut text_cache: eez_text_cache_stats_t = unsafe { mem::zeroed() };
+        let mut gauge: gauge_stats_t = unsafe { mem::zeroed() };
+        let mut static_layer: static_layer_stats_t = unsafe { mem::zeroed() };
+        let mut shadow_cache: lvgl_port_shadow_stats_t = unsafe { mem::zeroed() };
+        let mut digit_atlas: digit_atlas_stats_t = unsafe { mem::zeroed() };
+        let mut flow_alloc: eez_alloc_stats_t = unsafe { mem::zeroed() };
+        unsafe {
+            lvgl_port_get_stats(&mut stats);
+            lvgl_port_get_queue_stats(&mut queue);
+            eez_flow_get_text_cache_stats(&mut text_cache);
+            gauge_get_stats(&mut gauge);
+            static_layer_get_stats(&mut static_layer);
+            lvgl_port_get_shadow_stats(&mut shadow_cache);
+            digit_atlas_get_stats(&mut digit_atlas);
+            eez_flow_get_alloc_stats(&mut flow_alloc);
+        }
+
+        let json = serde_json::to_vec(&RenderStats::new(
+            stats,
+            queue,
+            text_cache,
+            gauge,
+            static_layer,
+            shadow_cache,
+            digit_atlas,
+            flow_alloc,
+        ))
+        .map_err(|e| anyhow::anyhow!("Stats serialization failed: {e}"))?;
+
+        req.into_response(200, None, &[("Content-Type", "application/json")])?
+            .write_all(&json)?;
+
+        Ok(())
+    }
+
     fn save_device(
         device: DeviceType,
         mac: Option<Mac>,
@@ -1,13 +1,17 @@
 #![feature(atomic_try_update)]
 
+use std::ffi::c_void;
+use std::ptr;
 use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, Ordering};
 use std::thread::{self};
 use std::time::Duration;
 
 use esp_idf_svc::bt::ble::gatt::client::EspGattc;
 use esp_idf_svc::eventloop::EspSystemEventLoop;
 use esp_idf_svc::sys::lcd_bindings::{
-    lvgl_port_lock, lvgl_port_unlock, ui_init, ui_tick, waveshare_esp32_s3_rgb_lcd_init,
+    lvgl_port_is_suspended, lvgl_port_lock, lvgl_port_post_call, lvgl_port_unlock, ui_init,
+    ui_tick, ui_tick_needed, waveshare_esp32_s3_rgb_lcd_init,
 };
 
 use anyhow::Result;
@@ -33,6 +37,14 @@ use wifi::Wifi;
 use crate::devices::DEVICES;
 use crate::ui::ui::{setup_backlight, subscribe_ui_events};
 
+// Set while a `ui_tick` is queued for the LVGL task
+static UI_TICK_QUEUED: AtomicBool = AtomicBool::new(false);
+
+unsafe extern "C" fn ui_tick_cb(_user_data: *mut c_void) {
+    UI_TICK_QUEUED.store(false, Ordering::Release);
+    unsafe { ui_tick() };
+}
+
 fn main() -> Result<()> {
     esp_idf_svc::sys::link_patches();
     // esp_idf_svc::log::EspLogger::initialize_default();
@@ -85,6 +97,7 @@ fn main() -> Result<()> {
 
     unsafe {
         if lvgl_port_lock(-1) {
+            ui::vars::publish_all();
             ui_init();
             info!("UI init");
 
@@ -104,12 +117,19 @@ fn main() -> Result<()> {
     info!("Vicmon app started");
 
     loop {
-        unsafe {
-            if lvgl_port_lock(-1) {
-                ui_tick();
+        // Values are picked up by the first tick after the UI is resumed
+        if unsafe { lvgl_port_is_suspended() } {
+            thread::sleep(Duration::from_millis(100));
+            continue;
+        }
 
-                lvgl_port_unlock();
-            }
+        // Let the LVGL task run the tick instead of waiting for the LVGL mutex, one at a time and only
+        // when a value was published or the flow has work queued
+        if unsafe { ui_tick_needed() }
+            && !UI_TICK_QUEUED.swap(true, Ordering::AcqRel)
+            && !unsafe { lvgl_port_post_call(Some(ui_tick_cb), ptr::null_mut()) }
+        {
+            UI_TICK_QUEUED.store(false, Ordering::Release);
         }
         thread::sleep(Duration::from_millis(10));
     }
@@ -1,8 +1,26 @@
 use std::{
     ffi::CString,
-    sync::{atomic::AtomicBool, RwLock},
+    ops::{Deref, DerefMut},
+    sync::{
+        LockResult, PoisonError, RwLock, RwLockReadGuard, RwLockWriteGuard, atomic::AtomicBool,
+    },
 };
 
+use esp_idf_svc::sys::lcd_bindings::{
+    NativeVariables, NativeVariables_NATIVE_VAR_AC_WATTS, NativeVariables_NATIVE_VAR_BATT_AMP,
+    NativeVariables_NATIVE_VAR_BATT_SOC, NativeVariables_NATIVE_VAR_BATT_TEMP,
+    NativeVariables_NATIVE_VAR_BATT_VOLT, NativeVariables_NATIVE_VAR_IP_ADDR,
+    NativeVariables_NATIVE_VAR_SOLAR_WATTS, NativeVariables_NATIVE_VAR_SOLAR_YIELD,
+    VictronChargerError, VictronChargerError_VICTRON_CHARGER_ERROR_NONE,
+    VictronChargerError_VICTRON_CHARGER_ERROR_NOT_APPLICABLE, VictronMode,
+    VictronMode_VICTRON_MODE_INVERTING, VictronMode_VICTRON_MODE_NOT_APPLICABLE,
+    VictronMode_VICTRON_MODE_OFF, VictronVeBusError, VictronVeBusError_VICTRON_VEBUS_ERROR_NONE,
+    VictronVeBusError_VICTRON_VEBUS_ERROR_NOT_APPLICABLE, native_code_t, native_var_changed,
+    native_var_publish_bool, native_var_publish_code, native_var_publish_float,
+    native_var_publish_int, native_var_publish_string,
+};
+use victron_ble::{ErrorState, Mode};
+
 use self::ui::OnDuration;
 
 const DEFAULT_DELAY: u64 = 30_u64;
@@ -11,19 +29,172 @@ pub static ON_DURATION: OnDuration = OnDuration::new();
 
 pub static INVERTER_ON: AtomicBool = AtomicBool::new(false);
 pub static INVERTER_PREV: AtomicBool = AtomicBool::new(false);
-pub static INV_MODE: RwLock<Option<CString>> = RwLock::new(None);
-pub static INV_ERROR: RwLock<Option<CString>> = RwLock::new(None);
-pub static AC_WATTS: RwLock<i32> = RwLock::new(0i32);
-pub static BATT_SOC: RwLock<f32> = RwLock::new(0f32);
-pub static BATT_VOLT: RwLock<f32> = RwLock::new(0f32);
-pub static BATT_AMP: RwLock<f32> = RwLock::new(0f32);
-pub static BATT_TEMP: RwLock<i32> = RwLock::new(0i32);
-pub static BATT_ALARM: RwLock<Option<CString>> = RwLock::new(None);
-pub static SOLAR_WATTS: RwLock<i32> = RwLock::new(0i32);
-pub static SOLAR_YIELD: RwLock<i32> = RwLock::new(0i32);
-pub static SOLAR_MODE: RwLock<Option<CString>> = RwLock::new(None);
-pub static SOLAR_ERROR: RwLock<Option<CString>> = RwLock::new(None);
-pub static IP_ADDR: RwLock<Option<CString>> = RwLock::new(None);
+pub static AC_WATTS: NativeVar<i32> = NativeVar::new(NativeVariables_NATIVE_VAR_AC_WATTS, 0i32);
+pub static BATT_SOC: NativeVar<f32> = NativeVar::new(NativeVariables_NATIVE_VAR_BATT_SOC, 0f32);
+pub static BATT_VOLT: NativeVar<f32> = NativeVar::new(NativeVariables_NATIVE_VAR_BATT_VOLT, 0f32);
+pub static BATT_AMP: NativeVar<f32> = NativeVar::new(NativeVariables_NATIVE_VAR_BATT_AMP, 0f32);
+pub static BATT_TEMP: NativeVar<i32> = NativeVar::new(NativeVariables_NATIVE_VAR_BATT_TEMP, 0i32);
+pub static SOLAR_WATTS: NativeVar<i32> =
+    NativeVar::new(NativeVariables_NATIVE_VAR_SOLAR_WATTS, 0i32);
+pub static SOLAR_YIELD: NativeVar<i32> =
+    NativeVar::new(NativeVariables_NATIVE_VAR_SOLAR_YIELD, 0i32);
+pub static IP_ADDR: NativeVar<Option<CString>> =
+    NativeVar::new(NativeVariables_NATIVE_VAR_IP_ADDR, None);
+
+/// Tell the UI that a native variable was written, so the tick re-evaluates the properties bound to it
+pub fn var_changed(var: NativeVariables) {
+    unsafe { native_var_changed(var) };
+}
+
+/// Publish the Victron protocol code of an enum like variable, the UI maps it to a static text
+pub fn publish_code(var: NativeVariables, code: native_code_t) {
+    unsafe { native_var_publish_code(var, code) };
+}
+
+// The variants the firmware doesn't name pass on their discriminant, which victron_ble sets to the protocol code.
+// The named ones are checked against the codes of the C enums
+const _: () = assert!(Mode::Off as VictronMode == VictronMode_VICTRON_MODE_OFF);
+const _: () = assert!(Mode::Inverting as VictronMode == VictronMode_VICTRON_MODE_INVERTING);
+const _: () =
+    assert!(Mode::NotApplicable as VictronMode == VictronMode_VICTRON_MODE_NOT_APPLICABLE);
+const _: () = assert!(
+    ErrorState::NoError as VictronChargerError == VictronChargerError_VICTRON_CHARGER_ERROR_NONE
+);
+const _: () = assert!(
+    ErrorState::NotApplicable as VictronChargerError
+        == VictronChargerError_VICTRON_CHARGER_ERROR_NOT_APPLICABLE
+);
+
+/// The VictronMode code of a device state
+pub fn mode_code(mode: Mode) -> native_code_t {
+    let code: VictronMode = match mode {
+        Mode::Off => VictronMode_VICTRON_MODE_OFF,
+        Mode::Inverting => VictronMode_VICTRON_MODE_INVERTING,
+        Mode::NotApplicable => VictronMode_VICTRON_MODE_NOT_APPLICABLE,
+        mode => mode as VictronMode,
+    };
+    code as native_code_t
+}
+
+/// The VictronChargerError code of a solar charger error
+pub fn charger_error_code(error: ErrorState) -> native_code_t {
+    let code: VictronChargerError = match error {
+        ErrorState::NoError => VictronChargerError_VICTRON_CHARGER_ERROR_NONE,
+        ErrorState::NotApplicable => VictronChargerError_VICTRON_CHARGER_ERROR_NOT_APPLICABLE,
+        error => error as VictronChargerError,
+    };
+    code as native_code_t
+}
+
+/// The VictronVeBusError code of an inverter error, which victron_ble decodes into an ErrorState holding the
+/// VE.Bus error byte
+pub fn vebus_error_code(error: ErrorState) -> native_code_t {
+    let code: VictronVeBusError = match error {
+        ErrorState::NoError => VictronVeBusError_VICTRON_VEBUS_ERROR_NONE,
+        ErrorState::NotApplicable => VictronVeBusError_VICTRON_VEBUS_ERROR_NOT_APPLICABLE,
+        error => error as VictronVeBusError,
+    };
+    code as native_code_t
+}
+
+/// A value that can be published to the UI's snapshot of the native variables
+pub trait NativeValue {
+    fn publish(&self, var: NativeVariables);
+}
+
+impl NativeValue for bool {
+    fn publish(&self, var: NativeVariables) {
+        unsafe { native_var_publish_bool(var, *self) };
+    }
+}
+
+impl NativeValue for i32 {
+    fn publish(&self, var: NativeVariables) {
+        unsafe { native_var_publish_int(var, *self) };
+    }
+}
+
+impl NativeValue for f32 {
+    fn publish(&self, var: NativeVariables) {
+        unsafe { native_var_publish_float(var, *self) };
+    }
+}
+
+impl NativeValue for CString {
+    fn publish(&self, var: NativeVariables) {
+        unsafe { native_var_publish_string(var, self.as_ptr()) };
+    }
+}
+
+impl NativeValue for Option<CString> {
+    fn publish(&self, var: NativeVariables) {
+        let value = self.as_deref().unwrap_or(c"");
+        unsafe { native_var_publish_string(var, value.as_ptr()) };
+    }
+}
+
+/// A native UI variable, every write is published to the UI once the write guard is dropped
+pub struct NativeVar<T: NativeValue> {
+    var: NativeVariables,
+    value: RwLock<T>,
+}
+
+impl<T: NativeValue> NativeVar<T> {
+    pub const fn new(var: NativeVariables, value: T) -> Self {
+        Self {
+            var,
+            value: RwLock::new(value),
+        }
+    }
+
+    pub fn read(&self) -> LockResult<RwLockReadGuard<'_, T>> {
+        self.value.read()
+    }
+
+    /// Publish the current value again
+    pub fn publish(&self) {
+        self.value.read().unwrap().publish(self.var);
+    }
+
+    pub fn write(&self) -> LockResult<NativeVarGuard<'_, T>> {
+        match self.value.write() {
+            Ok(guard) => Ok(NativeVarGuard {
+                var: self.var,
+                guard,
+            }),
+            Err(e) => Err(PoisonError::new(NativeVarGuard {
+                var: self.var,
+                guard: e.into_inner(),
+            })),
+        }
+    }
+}
+
+pub struct NativeVarGuard<'a, T: NativeValue> {
+    var: NativeVariables,
+    guard: RwLockWriteGuard<'a, T>,
+}
+
+impl<T: NativeValue> Deref for NativeVarGuard<'_, T> {
+    type Target = T;
+
+    fn deref(&self) -> &T {
+        &self.guard
+    }
+}
+
+impl<T: NativeValue> DerefMut for NativeVarGuard<'_, T> {
+    fn deref_mut(&mut self) -> &mut T {
+        &mut self.guard
+    }
+}
+
+impl<T: NativeValue> Drop for NativeVarGuard<'_, T> {
+    fn drop(&mut self) {
+        // Published while still holding the lock, so writers publish in the order they wrote
+        self.guard.publish(self.var);
+    }
+}
 
 pub mod ui;
 pub mod vars;
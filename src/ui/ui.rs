@@ -17,8 +17,8 @@ use esp_idf_svc::{
         ESP_ERR_TIMEOUT, ESP_OK, esp_event_post,
         lcd_bindings::{
             lv_event_cb_t, lv_event_code_t, lv_event_code_t_LV_EVENT_PRESSED, lv_event_get_code,
-            lv_event_get_user_data, lv_event_t, lv_obj_add_event_cb, objects,
-            wavesahre_rgb_lcd_bl_off, wavesahre_rgb_lcd_bl_on,
+            lv_event_get_user_data, lv_event_t, lv_obj_add_event_cb, lvgl_port_resume,
+            lvgl_port_suspend, objects, wavesahre_rgb_lcd_bl_off, wavesahre_rgb_lcd_bl_on,
         },
     },
 };
@@ -28,7 +28,10 @@ use num_enum::TryFromPrimitive;
 use crate::{
     client::Client,
     devices::{Device, DeviceType},
-    ui::vars::{CONFIG_BMV, CONFIG_INV, CONFIG_MPPT, get_var_backlight_delay},
+    ui::vars::{
+        CONFIG_BMV, CONFIG_INV, CONFIG_MPPT, get_var_backlight_delay, publish_config_bmv,
+        publish_config_inv, publish_config_mppt,
+    },
     wifi::Wifi,
 };
 
@@ -104,10 +107,17 @@ pub fn setup_backlight(sys_loop: EspEventLoop<System>) {
 }
 
 fn turn_backlight_on(on: bool) -> bool {
+    // Nothing is visible while dark, so stop rendering until the backlight comes back on
     if on {
-        unsafe { wavesahre_rgb_lcd_bl_on() };
+        unsafe {
+            lvgl_port_resume();
+            wavesahre_rgb_lcd_bl_on();
+        }
     } else {
-        unsafe { wavesahre_rgb_lcd_bl_off() };
+        unsafe {
+            wavesahre_rgb_lcd_bl_off();
+            lvgl_port_suspend();
+        }
     }
 
     on
@@ -318,16 +328,22 @@ pub fn config_device(device: &Device) {
             config.0 = CString::new(device.addr().to_string()).unwrap();
             config.1 = CString::new(hex::encode_upper(device.key())).unwrap();
             config.2 = CString::new(format!("{:06}", device.pin().unwrap_or(0))).unwrap();
+            drop(config);
+            publish_config_inv();
         }
         DeviceType::Mppt => {
             let mut config = CONFIG_MPPT.write().unwrap();
             config.0 = CString::new(device.addr().to_string()).unwrap();
             config.1 = CString::new(hex::encode_upper(device.key())).unwrap();
+            drop(config);
+            publish_config_mppt();
         }
         DeviceType::Bmv => {
             let mut config = CONFIG_BMV.write().unwrap();
             config.0 = CString::new(device.addr().to_string()).unwrap();
             config.1 = CString::new(hex::encode_upper(device.key())).unwrap();
+            drop(config);
+            publish_config_bmv();
         }
     }
 }
@@ -1,5 +1,20 @@
 use std::{ffi::CStr, sync::LazyLock};
 
+use esp_idf_svc::sys::lcd_bindings::{
+    NativeVariables_NATIVE_VAR_AC_WATTS, NativeVariables_NATIVE_VAR_BACKLIGHT_DELAY,
+    NativeVariables_NATIVE_VAR_BATT_ALARM, NativeVariables_NATIVE_VAR_BATT_AMP,
+    NativeVariables_NATIVE_VAR_BATT_SOC, NativeVariables_NATIVE_VAR_BATT_TEMP,
+    NativeVariables_NATIVE_VAR_BATT_VOLT, NativeVariables_NATIVE_VAR_BMV_KEY,
+    NativeVariables_NATIVE_VAR_BMV_MAC, NativeVariables_NATIVE_VAR_INV_ERROR,
+    NativeVariables_NATIVE_VAR_INV_KEY, NativeVariables_NATIVE_VAR_INV_MAC,
+    NativeVariables_NATIVE_VAR_INV_MODE, NativeVariables_NATIVE_VAR_INV_PIN,
+    NativeVariables_NATIVE_VAR_INV_SWITCH, NativeVariables_NATIVE_VAR_IP_ADDR,
+    NativeVariables_NATIVE_VAR_MPPT_KEY, NativeVariables_NATIVE_VAR_MPPT_MAC,
+    NativeVariables_NATIVE_VAR_SOLAR_ERROR, NativeVariables_NATIVE_VAR_SOLAR_MODE,
+    NativeVariables_NATIVE_VAR_SOLAR_WATTS, NativeVariables_NATIVE_VAR_SOLAR_YIELD,
+    VictronMode_VICTRON_MODE_NOT_APPLICABLE, native_code_t, native_var_value,
+};
+
 use super::*;
 
 const EMPTY_STR: &CStr = c"";
@@ -16,38 +31,29 @@ pub extern "C" fn get_var_inv_switch() -> bool {
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_switch(value: bool) {
     INVERTER_ON.store(value, std::sync::atomic::Ordering::Relaxed);
+    value.publish(NativeVariables_NATIVE_VAR_INV_SWITCH);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_inv_mode() -> Cstring {
-    INV_MODE
-        .read()
-        .unwrap()
-        .as_ref()
-        .map(|s| s.as_c_str())
-        .unwrap_or(EMPTY_STR)
-        .as_ptr()
+    unsafe { native_var_value(NativeVariables_NATIVE_VAR_INV_MODE) as _ }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_mode(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_INV_MODE);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_inv_error() -> Cstring {
-    INV_ERROR
-        .read()
-        .unwrap()
-        .as_ref()
-        .map(|s| s.as_c_str())
-        .unwrap_or(EMPTY_STR)
-        .as_ptr()
+    unsafe { native_var_value(NativeVariables_NATIVE_VAR_INV_ERROR) as _ }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_error(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_INV_ERROR);
 }
 
 #[unsafe(no_mangle)]
@@ -57,7 +63,8 @@ pub extern "C" fn get_var_ac_watts() -> i32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_ac_watts(_value: i32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_AC_WATTS);
 }
 
 //---------
@@ -70,7 +77,8 @@ pub extern "C" fn get_var_batt_soc() -> f32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_batt_soc(_value: f32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BATT_SOC);
 }
 
 #[unsafe(no_mangle)]
@@ -80,7 +88,8 @@ pub extern "C" fn get_var_batt_volt() -> f32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_batt_volt(_value: f32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BATT_VOLT);
 }
 
 #[unsafe(no_mangle)]
@@ -90,7 +99,8 @@ pub extern "C" fn get_var_batt_amp() -> f32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_batt_amp(_value: f32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BATT_AMP);
 }
 
 #[unsafe(no_mangle)]
@@ -100,23 +110,19 @@ pub extern "C" fn get_var_batt_temp() -> i32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_batt_temp(_value: i32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BATT_TEMP);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_batt_alarm() -> Cstring {
-    BATT_ALARM
-        .read()
-        .unwrap()
-        .as_ref()
-        .map(|s| s.as_c_str())
-        .unwrap_or(EMPTY_STR)
-        .as_ptr()
+    unsafe { native_var_value(NativeVariables_NATIVE_VAR_BATT_ALARM) as _ }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_batt_alarm(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BATT_ALARM);
 }
 
 //-------
@@ -129,7 +135,8 @@ pub extern "C" fn get_var_solar_watts() -> i32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_solar_watts(_value: i32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_SOLAR_WATTS);
 }
 
 #[unsafe(no_mangle)]
@@ -139,39 +146,30 @@ pub extern "C" fn get_var_solar_yield() -> i32 {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_solar_yield(_value: i32) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_SOLAR_YIELD);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_solar_mode() -> Cstring {
-    SOLAR_MODE
-        .read()
-        .unwrap()
-        .as_ref()
-        .map(|s| s.as_c_str())
-        .unwrap_or(EMPTY_STR)
-        .as_ptr()
+    unsafe { native_var_value(NativeVariables_NATIVE_VAR_SOLAR_MODE) as _ }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_solar_mode(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_SOLAR_MODE);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_solar_error() -> Cstring {
-    SOLAR_ERROR
-        .read()
-        .unwrap()
-        .as_ref()
-        .map(|s| s.as_c_str())
-        .unwrap_or(EMPTY_STR)
-        .as_ptr()
+    unsafe { native_var_value(NativeVariables_NATIVE_VAR_SOLAR_ERROR) as _ }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_solar_error(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_SOLAR_ERROR);
 }
 
 //--------
@@ -190,10 +188,14 @@ pub extern "C" fn get_var_ip_addr() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_ip_addr(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_IP_ADDR);
 }
 
-static BACKLIGHT_DELAY: RwLock<i32> = RwLock::new(DEFAULT_DELAY as _);
+static BACKLIGHT_DELAY: NativeVar<i32> = NativeVar::new(
+    NativeVariables_NATIVE_VAR_BACKLIGHT_DELAY,
+    DEFAULT_DELAY as _,
+);
 #[unsafe(no_mangle)]
 pub extern "C" fn get_var_backlight_delay() -> i32 {
     *BACKLIGHT_DELAY.read().unwrap()
@@ -225,7 +227,8 @@ pub extern "C" fn get_var_inv_mac() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_mac(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_INV_MAC);
 }
 
 #[unsafe(no_mangle)]
@@ -235,7 +238,8 @@ pub extern "C" fn get_var_inv_key() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_key(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_INV_KEY);
 }
 
 #[unsafe(no_mangle)]
@@ -245,7 +249,8 @@ pub extern "C" fn get_var_inv_pin() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_inv_pin(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_INV_PIN);
 }
 
 #[unsafe(no_mangle)]
@@ -255,7 +260,8 @@ pub extern "C" fn get_var_mppt_mac() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_mppt_mac(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_MPPT_MAC);
 }
 
 #[unsafe(no_mangle)]
@@ -265,7 +271,8 @@ pub extern "C" fn get_var_mppt_key() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_mppt_key(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_MPPT_KEY);
 }
 
 #[unsafe(no_mangle)]
@@ -275,7 +282,8 @@ pub extern "C" fn get_var_bmv_mac() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_bmv_mac(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BMV_MAC);
 }
 
 #[unsafe(no_mangle)]
@@ -285,5 +293,51 @@ pub extern "C" fn get_var_bmv_key() -> Cstring {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn set_var_bmv_key(_value: Cstring) {
-    // NOOP
+    // Not writable from the UI, have the next tick re-assert the native value
+    var_changed(NativeVariables_NATIVE_VAR_BMV_KEY);
+}
+
+/// Publish every variable, so the UI starts from the native values rather than the zeroed snapshot
+pub fn publish_all() {
+    get_var_inv_switch().publish(NativeVariables_NATIVE_VAR_INV_SWITCH);
+    AC_WATTS.publish();
+    BATT_SOC.publish();
+    BATT_VOLT.publish();
+    BATT_AMP.publish();
+    BATT_TEMP.publish();
+    SOLAR_WATTS.publish();
+    SOLAR_YIELD.publish();
+    IP_ADDR.publish();
+    BACKLIGHT_DELAY.publish();
+    // Code 0 is a mode too, show none until a device reports one
+    publish_code(
+        NativeVariables_NATIVE_VAR_INV_MODE,
+        VictronMode_VICTRON_MODE_NOT_APPLICABLE as native_code_t,
+    );
+    publish_code(
+        NativeVariables_NATIVE_VAR_SOLAR_MODE,
+        VictronMode_VICTRON_MODE_NOT_APPLICABLE as native_code_t,
+    );
+    publish_config_inv();
+    publish_config_mppt();
+    publish_config_bmv();
+}
+
+pub(super) fn publish_config_inv() {
+    let config = CONFIG_INV.read().unwrap();
+    config.0.publish(NativeVariables_NATIVE_VAR_INV_MAC);
+    config.1.publish(NativeVariables_NATIVE_VAR_INV_KEY);
+    config.2.publish(NativeVariables_NATIVE_VAR_INV_PIN);
+}
+
+pub(super) fn publish_config_mppt() {
+    let config = CONFIG_MPPT.read().unwrap();
+    config.0.publish(NativeVariables_NATIVE_VAR_MPPT_MAC);
+    config.1.publish(NativeVariables_NATIVE_VAR_MPPT_KEY);
+}
+
+pub(super) fn publish_config_bmv() {
+    let config = CONFIG_BMV.read().unwrap();
+    config.0.publish(NativeVariables_NATIVE_VAR_BMV_MAC);
+    config.1.publish(NativeVariables_NATIVE_VAR_BMV_KEY);
 }